@@ -0,0 +1,169 @@
+#include "batch.h"
+#include "func.h"
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+#ifdef __AVX2__
+static inline __m256d vabs(__m256d v) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+}
+
+// fabs(a - b) < EPS
+static inline __m256d vequal(__m256d a, __m256d b) {
+    return _mm256_cmp_pd(vabs(_mm256_sub_pd(a, b)), _mm256_set1_pd(EPS), _CMP_LT_OQ);
+}
+
+// a < b || equal(a, b)
+static inline __m256d vlessOrEqual(__m256d a, __m256d b) {
+    return _mm256_or_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ), vequal(a, b));
+}
+
+static inline __m256d vdistance(__m256d px, __m256d py, __m256d cx, __m256d cy) {
+    __m256d dx = _mm256_sub_pd(px, cx);
+    __m256d dy = _mm256_sub_pd(py, cy);
+    return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+}
+#endif
+
+// Предикаты: векторная версия (4 фигуры или точки за раз) и скалярная
+// версия для хвоста, которая вызывает эталонную функцию из func.cpp.
+// Для круга (a, b, c) = (центр x, центр y, радиус), для квадрата —
+// (левый верхний x, левый верхний y, сторона).
+struct InCircle {
+#ifdef __AVX2__
+    static int lanes(__m256d px, __m256d py, __m256d cx, __m256d cy, __m256d r) {
+        __m256d d = vdistance(px, py, cx, cy);
+        __m256d inside = _mm256_andnot_pd(vequal(d, r), _mm256_cmp_pd(d, r, _CMP_LT_OQ));
+        return _mm256_movemask_pd(inside);
+    }
+#endif
+    static bool one(const Point& p, double cx, double cy, double r) {
+        Circle c = {{cx, cy}, r};
+        return isPointInCircle(p, c);
+    }
+};
+
+struct OnCircle {
+#ifdef __AVX2__
+    static int lanes(__m256d px, __m256d py, __m256d cx, __m256d cy, __m256d r) {
+        return _mm256_movemask_pd(vequal(vdistance(px, py, cx, cy), r));
+    }
+#endif
+    static bool one(const Point& p, double cx, double cy, double r) {
+        Circle c = {{cx, cy}, r};
+        return isPointOnCircle(p, c);
+    }
+};
+
+struct InSquare {
+#ifdef __AVX2__
+    static int lanes(__m256d px, __m256d py, __m256d left, __m256d top, __m256d side) {
+        __m256d right = _mm256_add_pd(left, side);
+        __m256d bottom = _mm256_sub_pd(top, side);
+        __m256d inX = _mm256_and_pd(_mm256_cmp_pd(px, left, _CMP_GT_OQ), _mm256_cmp_pd(px, right, _CMP_LT_OQ));
+        __m256d inY = _mm256_and_pd(_mm256_cmp_pd(py, top, _CMP_LT_OQ), _mm256_cmp_pd(py, bottom, _CMP_GT_OQ));
+        return _mm256_movemask_pd(_mm256_and_pd(inX, inY));
+    }
+#endif
+    static bool one(const Point& p, double left, double top, double side) {
+        Square s = {{left, top}, side};
+        return isPointInSquare(p, s);
+    }
+};
+
+struct OnSquare {
+#ifdef __AVX2__
+    // Повторяет isPointOnSquare условие в условие, включая проверку
+    // горизонтальных сторон
+    static int lanes(__m256d px, __m256d py, __m256d left, __m256d top, __m256d side) {
+        __m256d right = _mm256_add_pd(left, side);
+        __m256d bottom = _mm256_sub_pd(top, side);
+        __m256d spanY = _mm256_and_pd(vlessOrEqual(py, top), vlessOrEqual(bottom, py));
+        __m256d spanX = _mm256_and_pd(vlessOrEqual(left, px), vlessOrEqual(px, right));
+        __m256d vertical = _mm256_and_pd(_mm256_or_pd(vequal(px, left), vequal(px, right)), spanY);
+        __m256d horizontal = _mm256_and_pd(_mm256_or_pd(vequal(py, top), vequal(py, bottom)), spanX);
+        return _mm256_movemask_pd(_mm256_or_pd(vertical, horizontal));
+    }
+#endif
+    static bool one(const Point& p, double left, double top, double side) {
+        Square s = {{left, top}, side};
+        return isPointOnSquare(p, s);
+    }
+};
+
+template <typename Pred>
+static void pointVsShapes(const Point& p, const AlignedDoubles& a, const AlignedDoubles& b,
+                          const AlignedDoubles& c, uint64_t* mask) {
+    size_t n = a.size();
+    fill(mask, mask + maskWords(n), 0);
+
+    size_t i = 0;
+#ifdef __AVX2__
+    __m256d px = _mm256_set1_pd(p.x);
+    __m256d py = _mm256_set1_pd(p.y);
+    for (; i + 4 <= n; i += 4) {
+        uint64_t bits = Pred::lanes(px, py, _mm256_load_pd(&a[i]), _mm256_load_pd(&b[i]), _mm256_load_pd(&c[i]));
+        mask[i / 64] |= bits << (i % 64);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (Pred::one(p, a[i], b[i], c[i])) mask[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+template <typename Pred>
+static void pointsVsShape(const PointBatch& points, double a, double b, double c, uint64_t* mask) {
+    size_t n = points.size();
+    fill(mask, mask + maskWords(n), 0);
+
+    size_t i = 0;
+#ifdef __AVX2__
+    __m256d va = _mm256_set1_pd(a);
+    __m256d vb = _mm256_set1_pd(b);
+    __m256d vc = _mm256_set1_pd(c);
+    for (; i + 4 <= n; i += 4) {
+        uint64_t bits = Pred::lanes(_mm256_load_pd(&points.x[i]), _mm256_load_pd(&points.y[i]), va, vb, vc);
+        mask[i / 64] |= bits << (i % 64);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (Pred::one(points.get(i), a, b, c)) mask[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+void isPointInCircle(const Point& p, const CircleBatch& circles, uint64_t* mask) {
+    pointVsShapes<InCircle>(p, circles.x, circles.y, circles.radius, mask);
+}
+
+void isPointInSquare(const Point& p, const SquareBatch& squares, uint64_t* mask) {
+    pointVsShapes<InSquare>(p, squares.x, squares.y, squares.side, mask);
+}
+
+void isPointOnCircle(const Point& p, const CircleBatch& circles, uint64_t* mask) {
+    pointVsShapes<OnCircle>(p, circles.x, circles.y, circles.radius, mask);
+}
+
+void isPointOnSquare(const Point& p, const SquareBatch& squares, uint64_t* mask) {
+    pointVsShapes<OnSquare>(p, squares.x, squares.y, squares.side, mask);
+}
+
+void isPointInCircle(const PointBatch& points, const Circle& c, uint64_t* mask) {
+    pointsVsShape<InCircle>(points, c.center.x, c.center.y, c.radius, mask);
+}
+
+void isPointInSquare(const PointBatch& points, const Square& s, uint64_t* mask) {
+    pointsVsShape<InSquare>(points, s.topLeft.x, s.topLeft.y, s.side, mask);
+}
+
+void isPointOnCircle(const PointBatch& points, const Circle& c, uint64_t* mask) {
+    pointsVsShape<OnCircle>(points, c.center.x, c.center.y, c.radius, mask);
+}
+
+void isPointOnSquare(const PointBatch& points, const Square& s, uint64_t* mask) {
+    pointsVsShape<OnSquare>(points, s.topLeft.x, s.topLeft.y, s.side, mask);
+}
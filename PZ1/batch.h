@@ -0,0 +1,89 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "structs.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <mm_malloc.h>
+
+// Аллокатор с выравниванием по 32 байта (ширина регистра AVX2)
+template <typename T>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        void* p = _mm_malloc(n * sizeof(T), 32);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) {
+        _mm_free(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+typedef std::vector<double, AlignedAllocator<double> > AlignedDoubles;
+
+// Набор точек (структура массивов)
+struct PointBatch {
+    AlignedDoubles x;
+    AlignedDoubles y;
+
+    size_t size() const { return x.size(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); }
+    void push(const Point& p) { x.push_back(p.x); y.push_back(p.y); }
+    Point get(size_t i) const { Point p = {x[i], y[i]}; return p; }
+};
+
+// Набор кругов (структура массивов)
+struct CircleBatch {
+    AlignedDoubles x;
+    AlignedDoubles y;
+    AlignedDoubles radius;
+
+    size_t size() const { return x.size(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); radius.reserve(n); }
+    void push(const Circle& c) { x.push_back(c.center.x); y.push_back(c.center.y); radius.push_back(c.radius); }
+    Circle get(size_t i) const { Circle c = {{x[i], y[i]}, radius[i]}; return c; }
+};
+
+// Набор квадратов (структура массивов)
+struct SquareBatch {
+    AlignedDoubles x;
+    AlignedDoubles y;
+    AlignedDoubles side;
+
+    size_t size() const { return x.size(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); side.reserve(n); }
+    void push(const Square& s) { x.push_back(s.topLeft.x); y.push_back(s.topLeft.y); side.push_back(s.side); }
+    Square get(size_t i) const { Square s = {{x[i], y[i]}, side[i]}; return s; }
+};
+
+// Битовые маски результатов: бит i слова i / 64 — ответ для i-го элемента
+inline size_t maskWords(size_t count) { return (count + 63) / 64; }
+inline bool maskTest(const uint64_t* mask, size_t i) { return (mask[i / 64] >> (i % 64)) & 1; }
+
+// Одна точка против набора фигур (mask — maskWords(shapes.size()) слов)
+void isPointInCircle(const Point& p, const CircleBatch& circles, uint64_t* mask);
+void isPointInSquare(const Point& p, const SquareBatch& squares, uint64_t* mask);
+void isPointOnCircle(const Point& p, const CircleBatch& circles, uint64_t* mask);
+void isPointOnSquare(const Point& p, const SquareBatch& squares, uint64_t* mask);
+
+// Набор точек против одной фигуры (mask — maskWords(points.size()) слов)
+void isPointInCircle(const PointBatch& points, const Circle& c, uint64_t* mask);
+void isPointInSquare(const PointBatch& points, const Square& s, uint64_t* mask);
+void isPointOnCircle(const PointBatch& points, const Circle& c, uint64_t* mask);
+void isPointOnSquare(const PointBatch& points, const Square& s, uint64_t* mask);
+
+#endif
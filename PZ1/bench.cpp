@@ -0,0 +1,198 @@
+// Пропускная способность предикатов func.h на случайных данных:
+// скалярные функции, пакетные (batch.h) и целочисленные (fixed.h)
+#include "batch.h"
+#include "fixed.h"
+#include "func.h"
+#include "workload.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const double MIN_SECONDS = 0.2;
+const double FIXED_SCALE = 65536;
+
+// Пары "проверяемый объект — опорная фигура" для одного вида нагрузки
+struct Inputs {
+    vector<Point> pcPoints, psPoints;
+    vector<Circle> pcCircles, ccFirst, ccSecond, csCircles, scCircles;
+    vector<Square> psSquares, ssFirst, ssSecond, csSquares, scSquares;
+
+    Inputs(Workload kind, size_t n) {
+        WorkloadGenerator gen(kind, 42 + kind);
+        for (size_t i = 0; i < n; ++i) {
+            Circle c = gen.circle();
+            Square s = gen.square();
+            pcCircles.push_back(c);
+            pcPoints.push_back(gen.pointNear(c));
+            psSquares.push_back(s);
+            psPoints.push_back(gen.pointNear(s));
+            ccSecond.push_back(c);
+            ccFirst.push_back(gen.circleNear(c));
+            ssSecond.push_back(s);
+            ssFirst.push_back(gen.squareNear(s));
+            csSquares.push_back(s);
+            csCircles.push_back(gen.circleNear(s));
+            scCircles.push_back(c);
+            scSquares.push_back(gen.squareNear(c));
+        }
+    }
+};
+
+template <typename A, typename B>
+vector<A> fixedCopy(const vector<B>& items) {
+    vector<A> result;
+    result.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) result.push_back(toFixed<int32_t>(items[i], FIXED_SCALE));
+    return result;
+}
+
+void report(const char* name, const char* variant, Workload kind, double calls, double seconds, size_t hits) {
+    printf("%-22s %-8s %-9s %9.1f Mcalls/s  hits %5.1f%%\n", name, variant, WORKLOAD_NAMES[kind],
+           calls / seconds / 1e6, 100.0 * hits / calls);
+}
+
+// Прогоны по всем парам, пока не наберется MIN_SECONDS
+template <typename A, typename B, typename F>
+void measure(const char* name, const char* variant, Workload kind, const vector<A>& a, const vector<B>& b, F f) {
+    size_t hits = 0;
+    double calls = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        for (size_t i = 0; i < a.size(); ++i) hits += f(a[i], b[i]);
+        calls += a.size();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    report(name, variant, kind, calls, seconds, hits);
+}
+
+template <typename Batch, typename Shape>
+void measureBatch(const char* name, Workload kind, const Batch& batch, const Shape& shape,
+                  void (*kernel)(const Batch&, const Shape&, uint64_t*)) {
+    vector<uint64_t> mask(maskWords(batch.size()));
+    size_t hits = 0;
+    double calls = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        kernel(batch, shape, mask.data());
+        for (size_t w = 0; w < mask.size(); ++w) hits += __builtin_popcountll(mask[w]);
+        calls += batch.size();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    report(name, "batch", kind, calls, seconds, hits);
+}
+
+void scalarAndFixed(Workload kind, const Inputs& in) {
+    measure("isPointInCircle", "scalar", kind, in.pcPoints, in.pcCircles,
+            [](const Point& p, const Circle& c) { return isPointInCircle(p, c); });
+    measure("isPointInSquare", "scalar", kind, in.psPoints, in.psSquares,
+            [](const Point& p, const Square& s) { return isPointInSquare(p, s); });
+    measure("isPointOnCircle", "scalar", kind, in.pcPoints, in.pcCircles,
+            [](const Point& p, const Circle& c) { return isPointOnCircle(p, c); });
+    measure("isPointOnSquare", "scalar", kind, in.psPoints, in.psSquares,
+            [](const Point& p, const Square& s) { return isPointOnSquare(p, s); });
+    measure("circlesIntersect", "scalar", kind, in.ccFirst, in.ccSecond,
+            [](const Circle& a, const Circle& b) { return circlesIntersect(a, b); });
+    measure("squaresIntersect", "scalar", kind, in.ssFirst, in.ssSecond,
+            [](const Square& a, const Square& b) { return squaresIntersect(a, b); });
+    measure("circleSquareIntersect", "scalar", kind, in.csCircles, in.csSquares,
+            [](const Circle& c, const Square& s) { return circleSquareIntersect(c, s); });
+    measure("isCircleInCircle", "scalar", kind, in.ccFirst, in.ccSecond,
+            [](const Circle& a, const Circle& b) { return isCircleInCircle(a, b); });
+    measure("isSquareInSquare", "scalar", kind, in.ssFirst, in.ssSecond,
+            [](const Square& a, const Square& b) { return isSquareInSquare(a, b); });
+    measure("isSquareInCircle", "scalar", kind, in.scSquares, in.scCircles,
+            [](const Square& s, const Circle& c) { return isSquareInCircle(s, c); });
+    measure("isCircleInSquare", "scalar", kind, in.csCircles, in.csSquares,
+            [](const Circle& c, const Square& s) { return isCircleInSquare(c, s); });
+
+    typedef FixedPoint<int32_t> FP;
+    typedef FixedCircle<int32_t> FC;
+    typedef FixedSquare<int32_t> FS;
+    vector<FP> pcPoints = fixedCopy<FP>(in.pcPoints), psPoints = fixedCopy<FP>(in.psPoints);
+    vector<FC> pcCircles = fixedCopy<FC>(in.pcCircles), ccFirst = fixedCopy<FC>(in.ccFirst);
+    vector<FC> ccSecond = fixedCopy<FC>(in.ccSecond), csCircles = fixedCopy<FC>(in.csCircles);
+    vector<FC> scCircles = fixedCopy<FC>(in.scCircles);
+    vector<FS> psSquares = fixedCopy<FS>(in.psSquares), ssFirst = fixedCopy<FS>(in.ssFirst);
+    vector<FS> ssSecond = fixedCopy<FS>(in.ssSecond), csSquares = fixedCopy<FS>(in.csSquares);
+    vector<FS> scSquares = fixedCopy<FS>(in.scSquares);
+
+    measure("isPointInCircle", "fixed32", kind, pcPoints, pcCircles,
+            [](const FP& p, const FC& c) { return isPointInCircle(p, c); });
+    measure("isPointInSquare", "fixed32", kind, psPoints, psSquares,
+            [](const FP& p, const FS& s) { return isPointInSquare(p, s); });
+    measure("isPointOnCircle", "fixed32", kind, pcPoints, pcCircles,
+            [](const FP& p, const FC& c) { return isPointOnCircle(p, c); });
+    measure("isPointOnSquare", "fixed32", kind, psPoints, psSquares,
+            [](const FP& p, const FS& s) { return isPointOnSquare(p, s); });
+    measure("circlesIntersect", "fixed32", kind, ccFirst, ccSecond,
+            [](const FC& a, const FC& b) { return circlesIntersect(a, b); });
+    measure("squaresIntersect", "fixed32", kind, ssFirst, ssSecond,
+            [](const FS& a, const FS& b) { return squaresIntersect(a, b); });
+    measure("circleSquareIntersect", "fixed32", kind, csCircles, csSquares,
+            [](const FC& c, const FS& s) { return circleSquareIntersect(c, s); });
+    measure("isCircleInCircle", "fixed32", kind, ccFirst, ccSecond,
+            [](const FC& a, const FC& b) { return isCircleInCircle(a, b); });
+    measure("isSquareInSquare", "fixed32", kind, ssFirst, ssSecond,
+            [](const FS& a, const FS& b) { return isSquareInSquare(a, b); });
+    measure("isSquareInCircle", "fixed32", kind, scSquares, scCircles,
+            [](const FS& s, const FC& c) { return isSquareInCircle(s, c); });
+    measure("isCircleInSquare", "fixed32", kind, csCircles, csSquares,
+            [](const FC& c, const FS& s) { return isCircleInSquare(c, s); });
+}
+
+// Много точек против одной фигуры: скалярный цикл и пакетное ядро
+void batched(Workload kind, size_t n) {
+    WorkloadGenerator gen(kind, 7 + kind);
+    Circle c = gen.circle();
+    Square s = gen.square();
+    vector<Point> nearCircle, nearSquare;
+    PointBatch circleBatch, squareBatch;
+    for (size_t i = 0; i < n; ++i) {
+        nearCircle.push_back(gen.pointNear(c));
+        nearSquare.push_back(gen.pointNear(s));
+        circleBatch.push(nearCircle.back());
+        squareBatch.push(nearSquare.back());
+    }
+    vector<Circle> circles(n, c);
+    vector<Square> squares(n, s);
+
+    measure("isPointInCircle", "scalar", kind, nearCircle, circles,
+            [](const Point& p, const Circle& c) { return isPointInCircle(p, c); });
+    measureBatch<PointBatch, Circle>("isPointInCircle", kind, circleBatch, c, isPointInCircle);
+    measure("isPointInSquare", "scalar", kind, nearSquare, squares,
+            [](const Point& p, const Square& s) { return isPointInSquare(p, s); });
+    measureBatch<PointBatch, Square>("isPointInSquare", kind, squareBatch, s, isPointInSquare);
+    measure("isPointOnCircle", "scalar", kind, nearCircle, circles,
+            [](const Point& p, const Circle& c) { return isPointOnCircle(p, c); });
+    measureBatch<PointBatch, Circle>("isPointOnCircle", kind, circleBatch, c, isPointOnCircle);
+    measure("isPointOnSquare", "scalar", kind, nearSquare, squares,
+            [](const Point& p, const Square& s) { return isPointOnSquare(p, s); });
+    measureBatch<PointBatch, Square>("isPointOnSquare", kind, squareBatch, s, isPointOnSquare);
+}
+
+}  // namespace
+
+// bench [число пар, по умолчанию 1 << 18]
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : (1u << 18);
+    if (n == 0) {
+        fprintf(stderr, "usage: bench [pairs]\n");
+        return 1;
+    }
+
+    printf("== pairs: %zu, one reference shape per pair ==\n", n);
+    for (int k = HIT; k <= BOUNDARY; ++k) {
+        Inputs in(static_cast<Workload>(k), n);
+        scalarAndFixed(static_cast<Workload>(k), in);
+    }
+    printf("\n== points against one shape: %zu ==\n", n);
+    for (int k = HIT; k <= BOUNDARY; ++k) batched(static_cast<Workload>(k), n);
+    return 0;
+}
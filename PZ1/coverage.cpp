@@ -0,0 +1,357 @@
+#include "coverage.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+int threadCount(int threads) {
+    if (threads > 0) return threads;
+    int hw = static_cast<int>(thread::hardware_concurrency());
+    return hw > 0 ? hw : 1;
+}
+
+template <typename Worker>
+void runParallel(int count, Worker worker) {
+    if (count <= 1) {
+        worker(0);
+        return;
+    }
+    vector<thread> pool;
+    for (int t = 0; t < count; ++t) pool.emplace_back(worker, t);
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+}
+
+// ---------- Точный режим ----------
+
+struct Event {
+    double x;
+    int low, high;  // отрезок элементарных интервалов по y
+    int delta;
+};
+
+// Дерево отрезков: сколько раз узел покрыт целиком и длина покрытой части
+class CoverTree {
+public:
+    explicit CoverTree(const vector<double>& ys)
+        : ys(ys), count(4 * max<size_t>(ys.size(), 1), 0), length(4 * max<size_t>(ys.size(), 1), 0) {}
+
+    void add(int low, int high, int delta) {
+        if (low < high) update(1, 0, static_cast<int>(ys.size()) - 1, low, high, delta);
+    }
+    double covered() const { return length[1]; }
+
+private:
+    const vector<double>& ys;
+    vector<int> count;
+    vector<double> length;
+
+    void update(int node, int l, int r, int low, int high, int delta) {
+        if (high <= l || r <= low) return;
+        if (low <= l && r <= high) {
+            count[node] += delta;
+        } else {
+            int mid = (l + r) / 2;
+            update(2 * node, l, mid, low, high, delta);
+            update(2 * node + 1, mid, r, low, high, delta);
+        }
+        if (count[node] > 0) length[node] = ys[r] - ys[l];
+        else if (r - l == 1) length[node] = 0;
+        else length[node] = length[2 * node] + length[2 * node + 1];
+    }
+};
+
+// Площадь объединения частей квадратов внутри полосы [left, right)
+double slabArea(const vector<Square>& squares, double left, double right) {
+    vector<double> ys;
+    for (size_t i = 0; i < squares.size(); ++i) {
+        const Square& s = squares[i];
+        if (s.side <= 0) continue;
+        double x0 = max(s.topLeft.x, left);
+        double x1 = min(s.topLeft.x + s.side, right);
+        if (x0 >= x1) continue;
+        ys.push_back(s.topLeft.y - s.side);
+        ys.push_back(s.topLeft.y);
+    }
+    if (ys.empty()) return 0;
+    sort(ys.begin(), ys.end());
+    ys.erase(unique(ys.begin(), ys.end()), ys.end());
+
+    vector<Event> events;
+    for (size_t i = 0; i < squares.size(); ++i) {
+        const Square& s = squares[i];
+        if (s.side <= 0) continue;
+        double x0 = max(s.topLeft.x, left);
+        double x1 = min(s.topLeft.x + s.side, right);
+        if (x0 >= x1) continue;
+        int low = static_cast<int>(lower_bound(ys.begin(), ys.end(), s.topLeft.y - s.side) - ys.begin());
+        int high = static_cast<int>(lower_bound(ys.begin(), ys.end(), s.topLeft.y) - ys.begin());
+        Event open = {x0, low, high, 1};
+        Event close = {x1, low, high, -1};
+        events.push_back(open);
+        events.push_back(close);
+    }
+    sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.x < b.x; });
+
+    CoverTree tree(ys);
+    double area = 0;
+    double prevX = events[0].x;
+    for (size_t k = 0; k < events.size(); ++k) {
+        area += tree.covered() * (events[k].x - prevX);
+        prevX = events[k].x;
+        tree.add(events[k].low, events[k].high, events[k].delta);
+    }
+    return area;
+}
+
+// ---------- Приближенный режим ----------
+
+const int TILE = 256;
+const uint8_t TOUCHED = 1, CENTER = 2, FULL = 4;
+
+struct Raster {
+    double originX, originY, cell;
+    int cols, rows;
+    int tilesX, tilesY;
+};
+
+// Фигуры, попадающие в каждый тайл (CSR)
+struct TileBins {
+    vector<int> start;
+    vector<int> items;
+};
+
+void tileRange(const Raster& g, const Box& b, int& tx0, int& ty0, int& tx1, int& ty1) {
+    double span = TILE * g.cell;
+    tx0 = max(0, static_cast<int>(floor((b.minX - g.originX) / span)));
+    ty0 = max(0, static_cast<int>(floor((b.minY - g.originY) / span)));
+    tx1 = min(g.tilesX - 1, static_cast<int>(floor((b.maxX - g.originX) / span)));
+    ty1 = min(g.tilesY - 1, static_cast<int>(floor((b.maxY - g.originY) / span)));
+}
+
+TileBins binShapes(const Raster& g, const vector<Shape>& shapes) {
+    TileBins bins;
+    bins.start.assign(static_cast<size_t>(g.tilesX) * g.tilesY + 1, 0);
+    vector<Box> boxes(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        boxes[i] = shapeBox(shapes[i]);
+        int tx0, ty0, tx1, ty1;
+        tileRange(g, boxes[i], tx0, ty0, tx1, ty1);
+        for (int ty = ty0; ty <= ty1; ++ty)
+            for (int tx = tx0; tx <= tx1; ++tx) ++bins.start[static_cast<size_t>(ty) * g.tilesX + tx + 1];
+    }
+    for (size_t t = 1; t < bins.start.size(); ++t) bins.start[t] += bins.start[t - 1];
+    bins.items.resize(bins.start.back());
+    vector<int> fill(bins.start.begin(), bins.start.end() - 1);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        int tx0, ty0, tx1, ty1;
+        tileRange(g, boxes[i], tx0, ty0, tx1, ty1);
+        for (int ty = ty0; ty <= ty1; ++ty)
+            for (int tx = tx0; tx <= tx1; ++tx)
+                bins.items[fill[static_cast<size_t>(ty) * g.tilesX + tx]++] = static_cast<int>(i);
+    }
+    return bins;
+}
+
+// Отметить в строке тайла ячейки, задетые отрезком [a, b] по x
+void markSpan(uint8_t* row, const Raster& g, int col0, int width, double a, double b, uint8_t bits) {
+    double u = (a - g.originX) / g.cell - col0;
+    double v = (b - g.originX) / g.cell - col0;
+    int first, last;  // включительно
+    if (bits == TOUCHED) {
+        first = static_cast<int>(floor(u));
+        last = static_cast<int>(ceil(v)) - 1;
+    } else if (bits == CENTER) {
+        first = static_cast<int>(ceil(u - 0.5));
+        last = static_cast<int>(floor(v - 0.5));
+    } else {
+        first = static_cast<int>(ceil(u));
+        last = static_cast<int>(floor(v)) - 1;
+    }
+    first = max(first, 0);
+    last = min(last, width - 1);
+    for (int c = first; c <= last; ++c) row[c] |= bits;
+}
+
+void rasterizeShape(uint8_t* tile, const Raster& g, int col0, int row0, int width, int height, const Shape& shape) {
+    Box b = shapeBox(shape);
+    int r0 = max(0, static_cast<int>(floor((b.minY - g.originY) / g.cell)) - row0);
+    int r1 = min(height - 1, static_cast<int>(ceil((b.maxY - g.originY) / g.cell)) - row0);
+    for (int r = r0; r <= r1; ++r) {
+        uint8_t* row = tile + static_cast<size_t>(r) * TILE;
+        double y0 = g.originY + (row0 + r) * g.cell;
+        double y1 = y0 + g.cell;
+        double yc = y0 + g.cell / 2;
+        if (shape.kind == Shape::SQUARE) {
+            if (y0 < b.maxY && y1 > b.minY) markSpan(row, g, col0, width, b.minX, b.maxX, TOUCHED);
+            if (yc >= b.minY && yc <= b.maxY) markSpan(row, g, col0, width, b.minX, b.maxX, CENTER);
+            if (y0 >= b.minY && y1 <= b.maxY) markSpan(row, g, col0, width, b.minX, b.maxX, FULL);
+            continue;
+        }
+        // Круг: полуширина хорды на нужной высоте
+        double cx = shape.circle.center.x;
+        double cy = shape.circle.center.y;
+        double r2 = shape.circle.radius * shape.circle.radius;
+        double near = (cy >= y0 && cy <= y1) ? 0 : min(fabs(y0 - cy), fabs(y1 - cy));
+        double far = max(fabs(y0 - cy), fabs(y1 - cy));
+        double mid = yc - cy;
+        if (near * near <= r2) {
+            double w = sqrt(r2 - near * near);
+            markSpan(row, g, col0, width, cx - w, cx + w, TOUCHED);
+        }
+        if (mid * mid <= r2) {
+            double w = sqrt(r2 - mid * mid);
+            markSpan(row, g, col0, width, cx - w, cx + w, CENTER);
+        }
+        if (far * far <= r2) {
+            double w = sqrt(r2 - far * far);
+            markSpan(row, g, col0, width, cx - w, cx + w, FULL);
+        }
+    }
+}
+
+bool sceneBox(const vector<Shape>& shapes, Box& box) {
+    if (shapes.empty()) return false;
+    box = shapeBox(shapes[0]);
+    for (size_t i = 1; i < shapes.size(); ++i) {
+        Box b = shapeBox(shapes[i]);
+        box.minX = min(box.minX, b.minX);
+        box.minY = min(box.minY, b.minY);
+        box.maxX = max(box.maxX, b.maxX);
+        box.maxY = max(box.maxY, b.maxY);
+    }
+    return true;
+}
+
+// Покрытие ячеек, общих для всех слоев, в пределах области area
+CoverageEstimate rasterCoverage(const vector<const vector<Shape>*>& layers, const Box& area,
+                                double cellSize, int threads) {
+    CoverageEstimate result = {0, 0};
+    double width = area.maxX - area.minX;
+    double height = area.maxY - area.minY;
+    if (width <= 0 || height <= 0) return result;
+
+    Raster g;
+    g.cell = cellSize > 0 ? cellSize : max(width, height) / 4096;
+    g.originX = area.minX;
+    g.originY = area.minY;
+    g.cols = max(1, static_cast<int>(ceil(width / g.cell)));
+    g.rows = max(1, static_cast<int>(ceil(height / g.cell)));
+    g.tilesX = (g.cols + TILE - 1) / TILE;
+    g.tilesY = (g.rows + TILE - 1) / TILE;
+
+    vector<TileBins> bins;
+    for (size_t l = 0; l < layers.size(); ++l) bins.push_back(binShapes(g, *layers[l]));
+
+    size_t tiles = static_cast<size_t>(g.tilesX) * g.tilesY;
+    int count = static_cast<int>(min<size_t>(threadCount(threads), tiles));
+    vector<uint64_t> touched(count, 0), center(count, 0), full(count, 0);
+    atomic<size_t> next(0);
+
+    runParallel(count, [&](int t) {
+        vector<uint8_t> combined(TILE * TILE);
+        vector<uint8_t> layer(TILE * TILE);
+        for (size_t tile = next++; tile < tiles; tile = next++) {
+            bool empty = false;
+            for (size_t l = 0; l < bins.size(); ++l)
+                if (bins[l].start[tile] == bins[l].start[tile + 1]) empty = true;
+            if (empty) continue;
+
+            int col0 = static_cast<int>(tile % g.tilesX) * TILE;
+            int row0 = static_cast<int>(tile / g.tilesX) * TILE;
+            int w = min(TILE, g.cols - col0);
+            int h = min(TILE, g.rows - row0);
+            for (size_t l = 0; l < layers.size(); ++l) {
+                uint8_t* target = l == 0 ? combined.data() : layer.data();
+                memset(target, 0, TILE * TILE);
+                const vector<Shape>& shapes = *layers[l];
+                for (int k = bins[l].start[tile]; k < bins[l].start[tile + 1]; ++k)
+                    rasterizeShape(target, g, col0, row0, w, h, shapes[bins[l].items[k]]);
+                if (l > 0)
+                    for (int c = 0; c < TILE * TILE; ++c) combined[c] &= layer[c];
+            }
+            for (int r = 0; r < h; ++r) {
+                const uint8_t* row = combined.data() + static_cast<size_t>(r) * TILE;
+                for (int c = 0; c < w; ++c) {
+                    touched[t] += row[c] & TOUCHED;
+                    center[t] += (row[c] & CENTER) >> 1;
+                    full[t] += (row[c] & FULL) >> 2;
+                }
+            }
+        }
+    });
+
+    uint64_t touchedCells = 0, centerCells = 0, fullCells = 0;
+    for (int t = 0; t < count; ++t) {
+        touchedCells += touched[t];
+        centerCells += center[t];
+        fullCells += full[t];
+    }
+    double cellArea = g.cell * g.cell;
+    result.area = centerCells * cellArea;
+    result.errorBound = max(result.area - fullCells * cellArea, touchedCells * cellArea - result.area);
+    return result;
+}
+
+}  // namespace
+
+double unionAreaExact(const vector<Square>& squares, int threads) {
+    vector<double> starts;
+    for (size_t i = 0; i < squares.size(); ++i)
+        if (squares[i].side > 0) starts.push_back(squares[i].topLeft.x);
+    if (starts.empty()) return 0;
+    sort(starts.begin(), starts.end());
+
+    // Границы полос — квантили левых краев, чтобы в полосах было примерно
+    // поровну квадратов
+    int count = static_cast<int>(min<size_t>(threadCount(threads), (starts.size() + 4095) / 4096));
+    count = max(count, 1);
+    vector<double> bounds(count + 1);
+    bounds[0] = -HUGE_VAL;
+    bounds[count] = HUGE_VAL;
+    for (int t = 1; t < count; ++t) bounds[t] = starts[starts.size() * t / count];
+
+    vector<double> areas(count, 0);
+    runParallel(count, [&](int t) {
+        if (bounds[t] < bounds[t + 1]) areas[t] = slabArea(squares, bounds[t], bounds[t + 1]);
+    });
+    double area = 0;
+    for (int t = 0; t < count; ++t) area += areas[t];
+    return area;
+}
+
+double overlapAreaExact(const vector<Square>& a, const vector<Square>& b, int threads) {
+    vector<Square> both(a);
+    both.insert(both.end(), b.begin(), b.end());
+    double overlap = unionAreaExact(a, threads) + unionAreaExact(b, threads) - unionAreaExact(both, threads);
+    return max(overlap, 0.0);
+}
+
+CoverageEstimate unionAreaApprox(const vector<Shape>& shapes, double cellSize, int threads) {
+    Box area;
+    if (!sceneBox(shapes, area)) {
+        CoverageEstimate none = {0, 0};
+        return none;
+    }
+    vector<const vector<Shape>*> layers(1, &shapes);
+    return rasterCoverage(layers, area, cellSize, threads);
+}
+
+CoverageEstimate overlapAreaApprox(const vector<Shape>& a, const vector<Shape>& b, double cellSize, int threads) {
+    CoverageEstimate none = {0, 0};
+    Box boxA, boxB;
+    if (!sceneBox(a, boxA) || !sceneBox(b, boxB)) return none;
+    // Пересечение возможно только в общей части сцен
+    Box area = {max(boxA.minX, boxB.minX), max(boxA.minY, boxB.minY),
+                min(boxA.maxX, boxB.maxX), min(boxA.maxY, boxB.maxY)};
+    if (area.minX >= area.maxX || area.minY >= area.maxY) return none;
+    vector<const vector<Shape>*> layers;
+    layers.push_back(&a);
+    layers.push_back(&b);
+    return rasterCoverage(layers, area, cellSize, threads);
+}
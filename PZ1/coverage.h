@@ -0,0 +1,33 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include "spatial.h"
+#include "structs.h"
+#include <vector>
+
+// Площадь объединения квадратов, точно: заметающая прямая по x с деревом
+// отрезков по y. Ось x делится на полосы, полосы считаются параллельно.
+// threads <= 0 — по числу ядер.
+double unionAreaExact(const std::vector<Square>& squares, int threads = 0);
+// Площадь пересечения объединений двух слоев квадратов:
+// |A| + |B| - |A U B|
+double overlapAreaExact(const std::vector<Square>& a, const std::vector<Square>& b, int threads = 0);
+
+// Приближенная площадь и гарантированная оценка погрешности:
+// |точная площадь - area| <= errorBound
+struct CoverageEstimate {
+    double area;
+    double errorBound;
+};
+
+// Растеризация на сетке с шагом cellSize по тайлам 256x256, тайлы
+// раздаются потокам. Ячейка считается покрытой по своему центру; ячейки,
+// целиком лежащие внутри фигуры, и ячейки, которых фигура касается,
+// дают нижнюю и верхнюю границы площади. cellSize <= 0 — около 4096
+// ячеек по длинной стороне сцены.
+CoverageEstimate unionAreaApprox(const std::vector<Shape>& shapes, double cellSize = 0, int threads = 0);
+// Площадь пересечения объединений двух слоев
+CoverageEstimate overlapAreaApprox(const std::vector<Shape>& a, const std::vector<Shape>& b,
+                                   double cellSize = 0, int threads = 0);
+
+#endif
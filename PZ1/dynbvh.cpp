@@ -0,0 +1,354 @@
+#include "dynbvh.h"
+#include <algorithm>
+
+using namespace std;
+
+static Box boxUnion(const Box& a, const Box& b) {
+    Box u = {min(a.minX, b.minX), min(a.minY, b.minY), max(a.maxX, b.maxX), max(a.maxY, b.maxY)};
+    return u;
+}
+
+static bool boxContains(const Box& outer, const Box& inner) {
+    return outer.minX <= inner.minX && outer.minY <= inner.minY &&
+           inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+}
+
+static double perimeter(const Box& b) {
+    return 2 * ((b.maxX - b.minX) + (b.maxY - b.minY));
+}
+
+DynamicBVH::DynamicBVH(double margin) : margin(margin), root(-1), freeList(-1), count(0) {}
+
+Box DynamicBVH::fatBox(const Shape& shape) const {
+    Box b = shapeBox(shape);
+    b.minX -= margin;
+    b.minY -= margin;
+    b.maxX += margin;
+    b.maxY += margin;
+    return b;
+}
+
+// Свободные узлы связаны через parent
+int DynamicBVH::allocateNode() {
+    int id;
+    if (freeList >= 0) {
+        id = freeList;
+        freeList = nodes[id].parent;
+    } else {
+        id = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+        shapes.push_back(Shape());
+        partnerLists.push_back(vector<int>());
+        movedFlag.push_back(0);
+    }
+    Node& node = nodes[id];
+    node.parent = node.child1 = node.child2 = -1;
+    node.height = 0;
+    return id;
+}
+
+void DynamicBVH::freeNode(int id) {
+    nodes[id].parent = freeList;
+    nodes[id].height = -1;
+    freeList = id;
+}
+
+int DynamicBVH::insert(const Shape& shape) {
+    int id = allocateNode();
+    shapes[id] = shape;
+    nodes[id].box = fatBox(shape);
+    insertLeaf(id);
+    markMoved(id);
+    ++count;
+    return id;
+}
+
+void DynamicBVH::remove(int id) {
+    vector<int>& list = partnerLists[id];
+    for (size_t k = 0; k < list.size(); ++k) {
+        int other = list[k];
+        vector<int>& back = partnerLists[other];
+        back.erase(find(back.begin(), back.end(), id));
+        pending.push_back(PairEvent{min(id, other), max(id, other), false});
+    }
+    list.clear();
+
+    removeLeaf(id);
+    freeNode(id);
+    --count;
+}
+
+bool DynamicBVH::move(int id, const Shape& shape) {
+    shapes[id] = shape;
+    markMoved(id);
+    if (boxContains(nodes[id].box, shapeBox(shape))) return false;
+
+    removeLeaf(id);
+    nodes[id].box = fatBox(shape);
+    insertLeaf(id);
+    return true;
+}
+
+void DynamicBVH::markMoved(int id) {
+    if (!movedFlag[id]) {
+        movedFlag[id] = 1;
+        moved.push_back(id);
+    }
+}
+
+// Лист вставляется рядом с узлом, где прирост периметра меньше всего
+void DynamicBVH::insertLeaf(int leaf) {
+    if (root < 0) {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    Box leafBox = nodes[leaf].box;
+    int index = root;
+    while (nodes[index].child1 >= 0) {
+        const Node& node = nodes[index];
+        double area = perimeter(node.box);
+        double combined = perimeter(boxUnion(node.box, leafBox));
+        double cost = 2 * combined;
+        double inheritance = 2 * (combined - area);
+
+        double costs[2];
+        int children[2] = {node.child1, node.child2};
+        for (int c = 0; c < 2; ++c) {
+            const Node& child = nodes[children[c]];
+            double grown = perimeter(boxUnion(leafBox, child.box));
+            costs[c] = (child.child1 < 0 ? grown : grown - perimeter(child.box)) + inheritance;
+        }
+
+        if (cost < costs[0] && cost < costs[1]) break;
+        index = costs[0] < costs[1] ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int newParent = allocateNode();
+    int oldParent = nodes[sibling].parent;
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = boxUnion(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent >= 0) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    refitUp(nodes[leaf].parent);
+}
+
+void DynamicBVH::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent >= 0) {
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitUp(grandParent);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = -1;
+        freeNode(parent);
+    }
+    nodes[leaf].parent = -1;
+}
+
+// Подъем к корню: балансировка, высота и прямоугольник каждого предка
+void DynamicBVH::refitUp(int index) {
+    while (index >= 0) {
+        index = balance(index);
+        Node& node = nodes[index];
+        const Node& a = nodes[node.child1];
+        const Node& b = nodes[node.child2];
+        node.height = 1 + max(a.height, b.height);
+        node.box = boxUnion(a.box, b.box);
+        index = node.parent;
+    }
+}
+
+// Поворот, если высоты поддеревьев a различаются больше чем на 1.
+// Возвращает узел, оказавшийся на месте a.
+int DynamicBVH::balance(int ia) {
+    Node& a = nodes[ia];
+    if (a.child1 < 0 || a.height < 2) return ia;
+
+    int ib = a.child1;
+    int ic = a.child2;
+    Node& b = nodes[ib];
+    Node& c = nodes[ic];
+    int diff = c.height - b.height;
+
+    // Поднимаем c
+    if (diff > 1) {
+        int iff = c.child1;
+        int ig = c.child2;
+        Node& f = nodes[iff];
+        Node& g = nodes[ig];
+
+        c.child1 = ia;
+        c.parent = a.parent;
+        a.parent = ic;
+        if (c.parent >= 0) {
+            if (nodes[c.parent].child1 == ia) {
+                nodes[c.parent].child1 = ic;
+            } else {
+                nodes[c.parent].child2 = ic;
+            }
+        } else {
+            root = ic;
+        }
+
+        if (f.height > g.height) {
+            c.child2 = iff;
+            a.child2 = ig;
+            g.parent = ia;
+            a.box = boxUnion(b.box, g.box);
+            c.box = boxUnion(a.box, f.box);
+            a.height = 1 + max(b.height, g.height);
+            c.height = 1 + max(a.height, f.height);
+        } else {
+            c.child2 = ig;
+            a.child2 = iff;
+            f.parent = ia;
+            a.box = boxUnion(b.box, f.box);
+            c.box = boxUnion(a.box, g.box);
+            a.height = 1 + max(b.height, f.height);
+            c.height = 1 + max(a.height, g.height);
+        }
+        return ic;
+    }
+
+    // Поднимаем b
+    if (diff < -1) {
+        int id = b.child1;
+        int ie = b.child2;
+        Node& d = nodes[id];
+        Node& e = nodes[ie];
+
+        b.child1 = ia;
+        b.parent = a.parent;
+        a.parent = ib;
+        if (b.parent >= 0) {
+            if (nodes[b.parent].child1 == ia) {
+                nodes[b.parent].child1 = ib;
+            } else {
+                nodes[b.parent].child2 = ib;
+            }
+        } else {
+            root = ib;
+        }
+
+        if (d.height > e.height) {
+            b.child2 = id;
+            a.child1 = ie;
+            e.parent = ia;
+            a.box = boxUnion(c.box, e.box);
+            b.box = boxUnion(a.box, d.box);
+            a.height = 1 + max(c.height, e.height);
+            b.height = 1 + max(a.height, d.height);
+        } else {
+            b.child2 = ie;
+            a.child1 = id;
+            d.parent = ia;
+            a.box = boxUnion(c.box, d.box);
+            b.box = boxUnion(a.box, e.box);
+            a.height = 1 + max(c.height, d.height);
+            b.height = 1 + max(a.height, e.height);
+        }
+        return ib;
+    }
+
+    return ia;
+}
+
+template <typename Visitor>
+void DynamicBVH::visitOverlaps(const Box& box, Visitor visit) const {
+    if (root < 0) return;
+
+    vector<int> stack;
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        if (!boxesOverlap(node.box, box)) continue;
+        if (node.child1 < 0) {
+            visit(index);
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+vector<int> DynamicBVH::query(const Shape& shape) const {
+    vector<int> result;
+    visitOverlaps(shapeBox(shape), [&](int id) {
+        if (shapesIntersect(shape, shapes[id])) result.push_back(id);
+    });
+    return result;
+}
+
+void DynamicBVH::update(const PairEventCallback& callback) {
+    for (size_t k = 0; k < pending.size(); ++k) callback(pending[k]);
+    pending.clear();
+
+    vector<int> current;
+    for (size_t m = 0; m < moved.size(); ++m) {
+        int id = moved[m];
+        movedFlag[id] = 0;
+        if (nodes[id].height < 0) continue;  // удалена после сдвига
+
+        current.clear();
+        visitOverlaps(shapeBox(shapes[id]), [&](int other) {
+            if (other != id && shapesIntersect(shapes[id], shapes[other])) current.push_back(other);
+        });
+        sort(current.begin(), current.end());
+
+        vector<int>& previous = partnerLists[id];
+        sort(previous.begin(), previous.end());
+
+        // Разность отсортированных списков: новые и исчезнувшие пары
+        size_t i = 0, j = 0;
+        while (i < current.size() || j < previous.size()) {
+            if (j == previous.size() || (i < current.size() && current[i] < previous[j])) {
+                int other = current[i++];
+                partnerLists[other].push_back(id);
+                callback(PairEvent{min(id, other), max(id, other), true});
+            } else if (i == current.size() || previous[j] < current[i]) {
+                int other = previous[j++];
+                vector<int>& back = partnerLists[other];
+                back.erase(find(back.begin(), back.end(), id));
+                callback(PairEvent{min(id, other), max(id, other), false});
+            } else {
+                ++i;
+                ++j;
+            }
+        }
+        previous = current;
+    }
+    moved.clear();
+}
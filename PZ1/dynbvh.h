@@ -0,0 +1,80 @@
+#ifndef DYNBVH_H
+#define DYNBVH_H
+
+#include "spatial.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Изменение пары: фигуры начали (started) или перестали пересекаться
+struct PairEvent {
+    int first;
+    int second;
+    bool started;
+};
+
+typedef std::function<void(const PairEvent& event)> PairEventCallback;
+
+// Динамическая BVH для движущихся фигур. Листья хранят "толстые"
+// прямоугольники, расширенные на margin: пока фигура не вышла за свой
+// толстый прямоугольник, дерево не меняется. Вставка и удаление листа
+// поднимаются к корню с перерасчетом прямоугольников и поворотами (как в
+// AVL-дереве), так что цена шага зависит от числа сдвинутых фигур, а не от
+// их общего количества.
+//
+// Пересекающиеся пары (shapesIntersect) хранятся списками соседей. update()
+// перепроверяет только фигуры, вставленные или сдвинутые с прошлого
+// вызова, и сообщает об изменениях пар.
+class DynamicBVH {
+public:
+    explicit DynamicBVH(double margin = 0.1);
+
+    // Возвращает идентификатор фигуры
+    int insert(const Shape& shape);
+    // Пары удаленной фигуры будут сообщены как прекращенные при update()
+    void remove(int id);
+    // true, если лист пришлось переставить в дереве
+    bool move(int id, const Shape& shape);
+
+    void update(const PairEventCallback& callback);
+
+    const Shape& getShape(int id) const { return shapes[id]; }
+    // Фигуры, сейчас пересекающиеся с id (на момент последнего update)
+    const std::vector<int>& partners(int id) const { return partnerLists[id]; }
+    std::vector<int> query(const Shape& shape) const;
+
+    size_t size() const { return count; }
+    int height() const { return root < 0 ? 0 : nodes[root].height; }
+
+private:
+    struct Node {
+        Box box;
+        int parent;
+        int child1, child2;  // -1 у листа
+        int height;          // 0 у листа, -1 у свободного узла
+    };
+
+    double margin;
+    int root;
+    int freeList;
+    size_t count;
+    std::vector<Node> nodes;
+    std::vector<Shape> shapes;               // по идентификатору листа
+    std::vector<std::vector<int> > partnerLists;
+    std::vector<int> moved;
+    std::vector<char> movedFlag;
+    std::vector<PairEvent> pending;
+
+    int allocateNode();
+    void freeNode(int id);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int a);
+    void refitUp(int index);
+    void markMoved(int id);
+    Box fatBox(const Shape& shape) const;
+    template <typename Visitor>
+    void visitOverlaps(const Box& box, Visitor visit) const;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include "structs.h"
+#include <cmath>
+#include <cstdint>
+
+// Целочисленные (fixed-point) координаты и точные предикаты для них.
+// Все сравнения делаются в целых без допуска, поэтому ответы на границе
+// не зависят от масштаба, компилятора и машины.
+//
+// Промежуточные значения считаются в более широком типе Wide:
+//   int32_t -> int64_t,  |координаты|, сторона, радиус <= 2^29
+//   int64_t -> __int128, |координаты|, сторона, радиус <= 2^61
+// В этих пределах ни разности, ни суммы квадратов не переполняются: самое
+// большое промежуточное значение — сумма двух квадратов 3 * 2^29 (2^61)
+// в isSquareInCircle, меньше 2^63 (2^127).
+// Для int32_t хватает 64-битных умножений, такие циклы хорошо
+// векторизуются.
+
+template <typename I>
+struct FixedTraits;
+
+template <>
+struct FixedTraits<int32_t> {
+    typedef int64_t Wide;
+};
+
+template <>
+struct FixedTraits<int64_t> {
+    typedef __int128 Wide;
+};
+
+template <typename I>
+struct FixedPoint {
+    I x;
+    I y;
+};
+
+template <typename I>
+struct FixedCircle {
+    FixedPoint<I> center;
+    I radius;
+};
+
+template <typename I>
+struct FixedSquare {
+    FixedPoint<I> topLeft;
+    I side;
+};
+
+// Перевод из double: unitsPerOne единиц на единицу длины, с округлением
+// до ближайшего
+template <typename I>
+inline FixedPoint<I> toFixed(const Point& p, double unitsPerOne) {
+    FixedPoint<I> f = {static_cast<I>(std::llround(p.x * unitsPerOne)), static_cast<I>(std::llround(p.y * unitsPerOne))};
+    return f;
+}
+
+template <typename I>
+inline FixedCircle<I> toFixed(const Circle& c, double unitsPerOne) {
+    FixedCircle<I> f = {toFixed<I>(c.center, unitsPerOne), static_cast<I>(std::llround(c.radius * unitsPerOne))};
+    return f;
+}
+
+template <typename I>
+inline FixedSquare<I> toFixed(const Square& s, double unitsPerOne) {
+    FixedSquare<I> f = {toFixed<I>(s.topLeft, unitsPerOne), static_cast<I>(std::llround(s.side * unitsPerOne))};
+    return f;
+}
+
+namespace detail {
+
+template <typename I>
+inline typename FixedTraits<I>::Wide wide(I v) { return static_cast<typename FixedTraits<I>::Wide>(v); }
+
+template <typename I>
+inline typename FixedTraits<I>::Wide distance2(const FixedPoint<I>& a, const FixedPoint<I>& b) {
+    typename FixedTraits<I>::Wide dx = wide(a.x) - wide(b.x);
+    typename FixedTraits<I>::Wide dy = wide(a.y) - wide(b.y);
+    return dx * dx + dy * dy;
+}
+
+}
+
+// Принадлежность точки кругу (строго внутри)
+template <typename I>
+inline bool isPointInCircle(const FixedPoint<I>& p, const FixedCircle<I>& c) {
+    return detail::distance2(p, c.center) < detail::wide(c.radius) * c.radius;
+}
+
+// Принадлежность точки квадрату (строго внутри)
+template <typename I>
+inline bool isPointInSquare(const FixedPoint<I>& p, const FixedSquare<I>& s) {
+    typename FixedTraits<I>::Wide right = detail::wide(s.topLeft.x) + s.side;
+    typename FixedTraits<I>::Wide bottom = detail::wide(s.topLeft.y) - s.side;
+    return (p.x > s.topLeft.x) & (p.x < right) & (p.y < s.topLeft.y) & (p.y > bottom);
+}
+
+// Точка на круге
+template <typename I>
+inline bool isPointOnCircle(const FixedPoint<I>& p, const FixedCircle<I>& c) {
+    return detail::distance2(p, c.center) == detail::wide(c.radius) * c.radius;
+}
+
+// Точка на квадрате
+template <typename I>
+inline bool isPointOnSquare(const FixedPoint<I>& p, const FixedSquare<I>& s) {
+    typename FixedTraits<I>::Wide right = detail::wide(s.topLeft.x) + s.side;
+    typename FixedTraits<I>::Wide bottom = detail::wide(s.topLeft.y) - s.side;
+    bool spanY = (p.y <= s.topLeft.y) & (bottom <= p.y);
+    bool spanX = (s.topLeft.x <= p.x) & (p.x <= right);
+    bool vertical = ((p.x == s.topLeft.x) | (p.x == right)) & spanY;
+    bool horizontal = ((p.y == s.topLeft.y) | (p.y == bottom)) & spanX;
+    return vertical | horizontal;
+}
+
+// Пересечение двух кругов: |r1 - r2| <= d <= r1 + r2
+template <typename I>
+inline bool circlesIntersect(const FixedCircle<I>& c1, const FixedCircle<I>& c2) {
+    typename FixedTraits<I>::Wide d2 = detail::distance2(c1.center, c2.center);
+    typename FixedTraits<I>::Wide sum = detail::wide(c1.radius) + c2.radius;
+    typename FixedTraits<I>::Wide diff = detail::wide(c1.radius) - c2.radius;
+    return (d2 <= sum * sum) & (diff * diff <= d2);
+}
+
+// Пересечение двух квадратов (касание не считается, как и для double)
+template <typename I>
+inline bool squaresIntersect(const FixedSquare<I>& s1, const FixedSquare<I>& s2) {
+    typename FixedTraits<I>::Wide right1 = detail::wide(s1.topLeft.x) + s1.side;
+    typename FixedTraits<I>::Wide bottom1 = detail::wide(s1.topLeft.y) - s1.side;
+    typename FixedTraits<I>::Wide right2 = detail::wide(s2.topLeft.x) + s2.side;
+    typename FixedTraits<I>::Wide bottom2 = detail::wide(s2.topLeft.y) - s2.side;
+    return !((right1 <= s2.topLeft.x) | (s1.topLeft.x >= right2) |
+             (bottom1 >= s2.topLeft.y) | (s1.topLeft.y <= bottom2));
+}
+
+// Пересечение круга и квадрата: ближайшая к центру точка квадрата
+template <typename I>
+inline bool circleSquareIntersect(const FixedCircle<I>& c, const FixedSquare<I>& s) {
+    typedef typename FixedTraits<I>::Wide Wide;
+    Wide left = s.topLeft.x;
+    Wide top = s.topLeft.y;
+    Wide right = left + s.side;
+    Wide bottom = top - s.side;
+    Wide cx = c.center.x;
+    Wide cy = c.center.y;
+    Wide dx = (cx < left ? left : (cx > right ? right : cx)) - cx;
+    Wide dy = (cy > top ? top : (cy < bottom ? bottom : cy)) - cy;
+    return dx * dx + dy * dy <= detail::wide(c.radius) * c.radius;
+}
+
+// Круг внутри круга: d + r1 <= r2
+template <typename I>
+inline bool isCircleInCircle(const FixedCircle<I>& c1, const FixedCircle<I>& c2) {
+    typename FixedTraits<I>::Wide room = detail::wide(c2.radius) - c1.radius;
+    return (room >= 0) & (detail::distance2(c1.center, c2.center) <= room * room);
+}
+
+// Квадрат внутри квадрата
+template <typename I>
+inline bool isSquareInSquare(const FixedSquare<I>& s1, const FixedSquare<I>& s2) {
+    typename FixedTraits<I>::Wide right1 = detail::wide(s1.topLeft.x) + s1.side;
+    typename FixedTraits<I>::Wide bottom1 = detail::wide(s1.topLeft.y) - s1.side;
+    typename FixedTraits<I>::Wide right2 = detail::wide(s2.topLeft.x) + s2.side;
+    typename FixedTraits<I>::Wide bottom2 = detail::wide(s2.topLeft.y) - s2.side;
+    return (s1.topLeft.x >= s2.topLeft.x) & (right1 <= right2) &
+           (s1.topLeft.y <= s2.topLeft.y) & (bottom1 >= bottom2);
+}
+
+// Квадрат внутри круга: все углы не дальше радиуса
+template <typename I>
+inline bool isSquareInCircle(const FixedSquare<I>& s, const FixedCircle<I>& c) {
+    typedef typename FixedTraits<I>::Wide Wide;
+    Wide xs[2] = {detail::wide(s.topLeft.x) - c.center.x, detail::wide(s.topLeft.x) + s.side - c.center.x};
+    Wide ys[2] = {detail::wide(s.topLeft.y) - c.center.y, detail::wide(s.topLeft.y) - s.side - c.center.y};
+    Wide r2 = detail::wide(c.radius) * c.radius;
+    bool inside = c.radius >= 0;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) inside &= xs[i] * xs[i] + ys[j] * ys[j] <= r2;
+    }
+    return inside;
+}
+
+// Круг внутри квадрата
+template <typename I>
+inline bool isCircleInSquare(const FixedCircle<I>& c, const FixedSquare<I>& s) {
+    typedef typename FixedTraits<I>::Wide Wide;
+    Wide cx = c.center.x;
+    Wide cy = c.center.y;
+    Wide right = detail::wide(s.topLeft.x) + s.side;
+    Wide bottom = detail::wide(s.topLeft.y) - s.side;
+    return (cx - c.radius >= s.topLeft.x) & (cx + c.radius <= right) &
+           (cy - c.radius >= bottom) & (cy + c.radius <= s.topLeft.y);
+}
+
+#endif
@@ -3,6 +3,9 @@
 
 #include "structs.h"
 
+// Погрешность сравнения double
+const double EPS = 1e-5;
+
 // Принадлежность точки фигуре (строго внутри)
 bool isPointInCircle(const Point& p, const Circle& c);
 bool isPointInSquare(const Point& p, const Square& s);
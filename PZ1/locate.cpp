@@ -0,0 +1,165 @@
+#include "locate.h"
+#include "predicates.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+PointLocator::PointLocator(const vector<Shape>& shapes)
+    : originX(0), originY(0), inverseCell(1), columns(1), rows(1) {
+    size_t n = shapes.size();
+    if (n == 0) {
+        cellStart.assign(2, 0);
+        return;
+    }
+
+    vector<Box> boxes(n);
+    Box bounds = shapeBox(shapes[0]);
+    double extentSum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        boxes[i] = shapeBox(shapes[i]);
+        bounds.minX = min(bounds.minX, boxes[i].minX);
+        bounds.minY = min(bounds.minY, boxes[i].minY);
+        bounds.maxX = max(bounds.maxX, boxes[i].maxX);
+        bounds.maxY = max(bounds.maxY, boxes[i].maxY);
+        extentSum += max(boxes[i].maxX - boxes[i].minX, boxes[i].maxY - boxes[i].minY);
+    }
+
+    // Ячейка порядка среднего размера фигуры, но не больше ~4 ячеек на фигуру
+    double width = bounds.maxX - bounds.minX;
+    double height = bounds.maxY - bounds.minY;
+    double cellSize = extentSum / n;
+    if (cellSize <= 0) cellSize = max(max(width, height), 1.0);
+    double maxCells = 4.0 * n + 16;
+    double cells = (width / cellSize + 1) * (height / cellSize + 1);
+    if (cells > maxCells) cellSize *= sqrt(cells / maxCells);
+
+    originX = bounds.minX;
+    originY = bounds.minY;
+    inverseCell = 1 / cellSize;
+    columns = static_cast<int>(width * inverseCell) + 1;
+    rows = static_cast<int>(height * inverseCell) + 1;
+
+    auto clampX = [&](double x) { return max(0, min(columns - 1, static_cast<int>(floor((x - originX) * inverseCell)))); };
+    auto clampY = [&](double y) { return max(0, min(rows - 1, static_cast<int>(floor((y - originY) * inverseCell)))); };
+
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (int y = clampY(boxes[i].minY); y <= clampY(boxes[i].maxY); ++y) {
+            for (int x = clampX(boxes[i].minX); x <= clampX(boxes[i].maxX); ++x) {
+                ++cellStart[y * columns + x + 1];
+            }
+        }
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    candidates.resize(cellStart.back());
+    vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        const Shape& s = shapes[i];
+        Candidate cand;
+        if (s.kind == Shape::CIRCLE) {
+            cand = Candidate{s.circle.center.x, s.circle.center.y, s.circle.radius, static_cast<int>(i), Shape::CIRCLE};
+        } else {
+            cand = Candidate{s.square.topLeft.x, s.square.topLeft.y, s.square.side, static_cast<int>(i), Shape::SQUARE};
+        }
+        for (int y = clampY(boxes[i].minY); y <= clampY(boxes[i].maxY); ++y) {
+            for (int x = clampX(boxes[i].minX); x <= clampX(boxes[i].maxX); ++x) {
+                candidates[fill[y * columns + x]++] = cand;
+            }
+        }
+    }
+}
+
+// Ячейка точки или -1, если точка вне сетки
+int PointLocator::cellOf(const Point& p) const {
+    double fx = (p.x - originX) * inverseCell;
+    double fy = (p.y - originY) * inverseCell;
+    if (!(fx >= 0 && fy >= 0)) return -1;
+    if (fx >= columns || fy >= rows) return -1;
+    return static_cast<int>(fy) * columns + static_cast<int>(fx);
+}
+
+void PointLocator::scanCell(int cell, const Point& p, vector<int>& out) const {
+    BasicPoint<double> bp = basic(p);
+    for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+        const Candidate& c = candidates[k];
+        bool inside;
+        if (c.kind == Shape::CIRCLE) {
+            BasicCircle<double> circle = {{c.a, c.b}, c.c};
+            inside = isPointInCircle(bp, circle);
+        } else {
+            BasicSquare<double> square = {{c.a, c.b}, c.c};
+            inside = isPointInSquare(bp, square);
+        }
+        if (inside) out.push_back(c.index);
+    }
+}
+
+void PointLocator::query(const Point& p, vector<int>& out) const {
+    int cell = cellOf(p);
+    if (cell >= 0) scanCell(cell, p, out);
+}
+
+void PointLocator::queryBatch(const vector<Point>& points, vector<int>& offsets,
+                              vector<int>& hits, int threads) const {
+    size_t n = points.size();
+
+    // Сортировка запросов по ячейкам подсчетом; точки вне сетки — в конец
+    size_t cells = cellCount();
+    vector<int> cellOfPoint(n);
+    vector<int> bucketStart(cells + 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+        int cell = cellOf(points[i]);
+        cellOfPoint[i] = cell < 0 ? static_cast<int>(cells) : cell;
+        ++bucketStart[cellOfPoint[i] + 1];
+    }
+    for (size_t c = 1; c < bucketStart.size(); ++c) {
+        bucketStart[c] += bucketStart[c - 1];
+    }
+    size_t inside = bucketStart[cells];
+    vector<int> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[bucketStart[cellOfPoint[i]]++] = static_cast<int>(i);
+    }
+
+    // Каждый поток обрабатывает свой отрезок отсортированных запросов и
+    // складывает пары (запрос, фигура) в свой буфер
+    if (threads <= 0) threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    threads = static_cast<int>(min<size_t>(threads, max<size_t>(inside / 4096, 1)));
+
+    vector<vector<int> > found(threads);
+    vector<vector<int> > foundQuery(threads);
+    auto work = [&](int t) {
+        size_t begin = inside * t / threads;
+        size_t end = inside * (t + 1) / threads;
+        vector<int>& shapes = found[t];
+        vector<int>& queries = foundQuery[t];
+        for (size_t k = begin; k < end; ++k) {
+            int q = order[k];
+            size_t before = shapes.size();
+            scanCell(cellOfPoint[q], points[q], shapes);
+            queries.insert(queries.end(), shapes.size() - before, q);
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) pool.push_back(thread(work, t));
+    work(0);
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+
+    // Сборка CSR в исходном порядке запросов
+    offsets.assign(n + 1, 0);
+    for (int t = 0; t < threads; ++t) {
+        for (size_t k = 0; k < foundQuery[t].size(); ++k) ++offsets[foundQuery[t][k] + 1];
+    }
+    for (size_t i = 1; i <= n; ++i) offsets[i] += offsets[i - 1];
+    hits.resize(offsets[n]);
+    vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int t = 0; t < threads; ++t) {
+        for (size_t k = 0; k < foundQuery[t].size(); ++k) hits[fill[foundQuery[t][k]]++] = found[t][k];
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef LOCATE_H
+#define LOCATE_H
+
+#include "spatial.h"
+#include <cstddef>
+#include <vector>
+
+// Неизменяемая структура "в каких фигурах лежит точка" над статическим
+// набором кругов и квадратов (принадлежность — isPointInCircle /
+// isPointInSquare, строго внутри). Сетка, в каждой ячейке — список фигур,
+// чьи прямоугольники ее задевают, с копией параметров фигуры рядом с
+// индексом. После построения только читается, поэтому запросы можно
+// выполнять из любого числа потоков без блокировок.
+class PointLocator {
+public:
+    explicit PointLocator(const std::vector<Shape>& shapes);
+
+    // Индексы фигур, содержащих p, дописываются в out
+    void query(const Point& p, std::vector<int>& out) const;
+
+    // Пакетный запрос. Результат в виде CSR: фигуры, содержащие points[i],
+    // лежат в hits[offsets[i] .. offsets[i + 1]). Запросы обрабатываются в
+    // порядке ячеек, threads <= 0 — по числу ядер.
+    void queryBatch(const std::vector<Point>& points, std::vector<int>& offsets,
+                    std::vector<int>& hits, int threads = 0) const;
+
+    size_t cellCount() const { return cellStart.size() - 1; }
+
+private:
+    struct Candidate {
+        double a, b, c;  // круг: центр и радиус, квадрат: левый верхний угол и сторона
+        int index;
+        int kind;
+    };
+
+    double originX, originY;
+    double inverseCell;
+    int columns, rows;
+    std::vector<int> cellStart;
+    std::vector<Candidate> candidates;
+
+    int cellOf(const Point& p) const;
+    void scanCell(int cell, const Point& p, std::vector<int>& out) const;
+};
+
+#endif
@@ -1,6 +1,14 @@
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "structs.h"
 #include "func.h"
+#include "shapeio.h"
+#include "sweep.h"
 
 using namespace std;
 
@@ -96,7 +104,218 @@ void demonstrateContainment() {
     cout << "Circle in Square: " << (isCircleInSquare(c1, s1) ? "YES" : "NO") << endl;
 }
 
-int main() {
+// Пакетный режим: structs --batch <предикат> <фигуры> [<запросы>] [-o <файл>]
+//
+// Точечные предикаты проверяют каждую точку из файла запросов (по умолчанию
+// из файла фигур) против каждой фигуры нужного вида. Остальные проверяют
+// фигуры первого вида из запросов против фигур второго вида из файла
+// фигур. Без файла запросов пара фигуры с собой не проверяется, а для
+// симметричных предикатов берется только i < j. Вывод — строки "i j" для
+// пар, где предикат истинен, одной записью в конце.
+struct BatchPredicate {
+    const char* name;
+    char queryKind;
+    char shapeKind;
+    bool symmetric;
+};
+
+static const BatchPredicate BATCH_PREDICATES[] = {
+    {"point-in-circle", 'P', 'C', false},
+    {"point-in-square", 'P', 'S', false},
+    {"point-on-circle", 'P', 'C', false},
+    {"point-on-square", 'P', 'S', false},
+    {"circles-intersect", 'C', 'C', true},
+    {"squares-intersect", 'S', 'S', true},
+    {"circle-square-intersect", 'C', 'S', false},
+    {"circle-in-circle", 'C', 'C', false},
+    {"square-in-square", 'S', 'S', false},
+    {"square-in-circle", 'S', 'C', false},
+    {"circle-in-square", 'C', 'S', false},
+};
+
+static void appendPair(string& out, size_t i, size_t j) {
+    char buf[48];
+    char* p = to_chars(buf, buf + 20, i).ptr;
+    *p++ = ' ';
+    p = to_chars(p, buf + 47, j).ptr;
+    *p++ = '\n';
+    out.append(buf, p);
+}
+
+template <typename Q, typename S, typename Pred>
+static size_t runPairs(const vector<Q>& queries, const vector<S>& shapes, bool self, bool symmetric,
+                       Pred pred, string& out) {
+    size_t hits = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        size_t j = (self && symmetric) ? i + 1 : 0;
+        for (; j < shapes.size(); ++j) {
+            if (self && i == j) continue;
+            if (pred(queries[i], shapes[j])) {
+                appendPair(out, i, j);
+                ++hits;
+            }
+        }
+    }
+    return hits;
+}
+
+// Пересечения внутри одного набора через sweep and prune
+static size_t runSelfIntersect(const ShapeSet& set, char kind, string& out) {
+    vector<Shape> shapes;
+    const vector<Circle>& circles = set.circles;
+    const vector<Square>& squares = set.squares;
+    if (kind != 'S') for (size_t i = 0; i < circles.size(); ++i) shapes.push_back(makeShape(circles[i]));
+    if (kind != 'C') for (size_t i = 0; i < squares.size(); ++i) shapes.push_back(makeShape(squares[i]));
+
+    vector<ShapePair> pairs = sweepAndPrune(shapes);
+    size_t circleCount = (kind == 'S') ? 0 : circles.size();
+    vector<pair<size_t, size_t> > result;
+    result.reserve(pairs.size());
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        size_t a = pairs[k].first;
+        size_t b = pairs[k].second;
+        if (kind == 'M') {
+            // Круг с квадратом: индекс круга, затем индекс квадрата
+            if ((a < circleCount) == (b < circleCount)) continue;
+            result.push_back(make_pair(min(a, b), max(a, b) - circleCount));
+        } else {
+            result.push_back(make_pair(a, b));
+        }
+    }
+    sort(result.begin(), result.end());
+    for (size_t k = 0; k < result.size(); ++k) {
+        appendPair(out, result[k].first, result[k].second);
+    }
+    return result.size();
+}
+
+int runBatch(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Usage: " << argv[0] << " --batch <predicate> <shapes> [<queries>] [-o <output>]" << endl;
+        cerr << "Predicates:";
+        for (const BatchPredicate& p : BATCH_PREDICATES) cerr << " " << p.name;
+        cerr << endl;
+        return 1;
+    }
+
+    const BatchPredicate* predicate = nullptr;
+    for (const BatchPredicate& p : BATCH_PREDICATES) {
+        if (strcmp(argv[2], p.name) == 0) predicate = &p;
+    }
+    if (!predicate) {
+        cerr << "Unknown predicate: " << argv[2] << endl;
+        return 1;
+    }
+
+    string shapesFile = argv[3];
+    string queriesFile;
+    string outputFile;
+    for (int i = 4; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            queriesFile = argv[i];
+        }
+    }
+
+    string error;
+    ShapeSet shapes;
+    ShapeSet queries;
+    if (!loadShapes(shapesFile, shapes, error) ||
+        (!queriesFile.empty() && !loadShapes(queriesFile, queries, error))) {
+        cerr << "Error: " << error << endl;
+        return 1;
+    }
+
+    bool self = queriesFile.empty();
+    const ShapeSet& q = self ? shapes : queries;
+    // Точки сами с собой не сравниваются, так что для них self не нужен
+    bool sameKind = self && predicate->queryKind == predicate->shapeKind;
+    string name = predicate->name;
+    string out;
+    size_t hits = 0;
+
+    if (self && name == "circles-intersect") {
+        hits = runSelfIntersect(shapes, 'C', out);
+    } else if (self && name == "squares-intersect") {
+        hits = runSelfIntersect(shapes, 'S', out);
+    } else if (self && name == "circle-square-intersect") {
+        hits = runSelfIntersect(shapes, 'M', out);
+    } else if (name == "point-in-circle") {
+        hits = runPairs(q.points, shapes.circles, false, false,
+                        [](const Point& p, const Circle& c) { return isPointInCircle(p, c); }, out);
+    } else if (name == "point-in-square") {
+        hits = runPairs(q.points, shapes.squares, false, false,
+                        [](const Point& p, const Square& s) { return isPointInSquare(p, s); }, out);
+    } else if (name == "point-on-circle") {
+        hits = runPairs(q.points, shapes.circles, false, false,
+                        [](const Point& p, const Circle& c) { return isPointOnCircle(p, c); }, out);
+    } else if (name == "point-on-square") {
+        hits = runPairs(q.points, shapes.squares, false, false,
+                        [](const Point& p, const Square& s) { return isPointOnSquare(p, s); }, out);
+    } else if (name == "circles-intersect") {
+        hits = runPairs(q.circles, shapes.circles, sameKind, true,
+                        [](const Circle& a, const Circle& b) { return circlesIntersect(a, b); }, out);
+    } else if (name == "squares-intersect") {
+        hits = runPairs(q.squares, shapes.squares, sameKind, true,
+                        [](const Square& a, const Square& b) { return squaresIntersect(a, b); }, out);
+    } else if (name == "circle-square-intersect") {
+        hits = runPairs(q.circles, shapes.squares, false, false,
+                        [](const Circle& c, const Square& s) { return circleSquareIntersect(c, s); }, out);
+    } else if (name == "circle-in-circle") {
+        hits = runPairs(q.circles, shapes.circles, sameKind, false,
+                        [](const Circle& a, const Circle& b) { return isCircleInCircle(a, b); }, out);
+    } else if (name == "square-in-square") {
+        hits = runPairs(q.squares, shapes.squares, sameKind, false,
+                        [](const Square& a, const Square& b) { return isSquareInSquare(a, b); }, out);
+    } else if (name == "square-in-circle") {
+        hits = runPairs(q.squares, shapes.circles, false, false,
+                        [](const Square& s, const Circle& c) { return isSquareInCircle(s, c); }, out);
+    } else if (name == "circle-in-square") {
+        hits = runPairs(q.circles, shapes.squares, false, false,
+                        [](const Circle& c, const Square& s) { return isCircleInSquare(c, s); }, out);
+    }
+
+    FILE* file = outputFile.empty() ? stdout : fopen(outputFile.c_str(), "wb");
+    if (!file) {
+        cerr << "Cannot create file: " << outputFile << endl;
+        return 1;
+    }
+    bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+    written = (file == stdout ? fflush(file) : fclose(file)) == 0 && written;
+    if (!written) {
+        cerr << "Write failed" << endl;
+        return 1;
+    }
+
+    cerr << predicate->name << ": " << hits << " matches" << endl;
+    return 0;
+}
+
+// structs --convert <текстовый файл> <двоичный файл>
+int runConvert(int argc, char* argv[]) {
+    if (argc != 4) {
+        cerr << "Usage: " << argv[0] << " --convert <input> <output.bin>" << endl;
+        return 1;
+    }
+
+    string error;
+    ShapeSet shapes;
+    if (!loadShapes(argv[2], shapes, error) || !saveShapesBinary(argv[3], shapes, error)) {
+        cerr << "Error: " << error << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--convert") == 0) {
+        return runConvert(argc, argv);
+    }
+
     demonstratePoint();
     demonstrateCircle();
     demonstrateSquare();
@@ -0,0 +1,214 @@
+#include "nesting.h"
+#include "func.h"
+#include <algorithm>
+#include <queue>
+
+using namespace std;
+
+double shapeArea(const Shape& shape) {
+    return shape.kind == Shape::CIRCLE ? circleArea(shape.circle) : squareArea(shape.square);
+}
+
+bool shapeContains(const Shape& outer, const Shape& inner) {
+    if (outer.kind == Shape::CIRCLE) {
+        return inner.kind == Shape::CIRCLE ? isCircleInCircle(inner.circle, outer.circle)
+                                           : isSquareInCircle(inner.square, outer.circle);
+    }
+    return inner.kind == Shape::CIRCLE ? isCircleInSquare(inner.circle, outer.square)
+                                       : isSquareInSquare(inner.square, outer.square);
+}
+
+namespace {
+
+Box boxUnion(const Box& a, const Box& b) {
+    Box u = {min(a.minX, b.minX), min(a.minY, b.minY), max(a.maxX, b.maxX), max(a.maxY, b.maxY)};
+    return u;
+}
+
+// Дерево прямоугольников (деление по медиане центров, как в BVH), в каждом
+// узле — наибольший ранг уже добавленных фигур поддерева. Поиск родителя
+// идет в первую очередь в узлы с большим рангом и отсекает узлы, чей
+// прямоугольник не накрывает фигуру. На вложенных сценах, где
+// прямоугольники всех больших фигур накрывают меньшую, он сразу спускается
+// к последней добавленной содержащей фигуре, а не перебирает всех предков.
+class RankedTree {
+public:
+    RankedTree(const vector<Shape>& shapes, const vector<int>& rank) : shapes(shapes), rank(rank) {
+        int n = static_cast<int>(shapes.size());
+        boxes.resize(n);
+        order.resize(n);
+        leafOf.resize(n);
+        added.assign(n, 0);
+        for (int i = 0; i < n; ++i) {
+            boxes[i] = shapeBox(shapes[i]);
+            order[i] = i;
+        }
+        if (n > 0) build(0, n, -1);
+    }
+
+    void add(int i) {
+        added[i] = 1;
+        for (int index = leafOf[i]; index >= 0 && nodes[index].maxRank < rank[i]; index = nodes[index].parent) {
+            nodes[index].maxRank = rank[i];
+        }
+    }
+
+    // Добавленная фигура наибольшего ранга, содержащая i, или -1
+    int deepestContainer(int i) {
+        Box target = boxes[i];
+        int best = -1;
+        int bestRank = -1;
+        open = priority_queue<pair<int, int> >();
+        if (!nodes.empty() && covers(nodes[0].box, target)) open.push(make_pair(nodes[0].maxRank, 0));
+        while (!open.empty() && open.top().first > bestRank) {
+            const Node& node = nodes[open.top().second];
+            open.pop();
+            if (node.left < 0) {
+                for (int k = node.start; k < node.start + node.count; ++k) {
+                    int c = order[k];
+                    if (added[c] && rank[c] > bestRank && shapeContains(shapes[c], shapes[i])) {
+                        best = c;
+                        bestRank = rank[c];
+                    }
+                }
+                continue;
+            }
+            int children[2] = {node.left, node.right};
+            for (int k = 0; k < 2; ++k) {
+                const Node& child = nodes[children[k]];
+                if (child.maxRank > bestRank && covers(child.box, target)) {
+                    open.push(make_pair(child.maxRank, children[k]));
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    struct Node {
+        Box box;
+        int left, right, parent;
+        int start, count;
+        int maxRank;  // -1, пока в поддереве нет добавленных фигур
+    };
+
+    const vector<Shape>& shapes;
+    const vector<int>& rank;
+    vector<Box> boxes;
+    vector<int> order;
+    vector<int> leafOf;
+    vector<char> added;
+    vector<Node> nodes;
+    priority_queue<pair<int, int> > open;
+
+    // Предикаты вложенности допускают выход за границу на EPS
+    static bool covers(const Box& outer, const Box& inner) {
+        return outer.minX <= inner.minX + EPS && outer.minY <= inner.minY + EPS &&
+               outer.maxX >= inner.maxX - EPS && outer.maxY >= inner.maxY - EPS;
+    }
+
+    int build(int start, int count, int parent) {
+        const int leafSize = 4;
+
+        Node node;
+        node.box = boxes[order[start]];
+        for (int k = start + 1; k < start + count; ++k) node.box = boxUnion(node.box, boxes[order[k]]);
+        node.left = node.right = -1;
+        node.parent = parent;
+        node.start = start;
+        node.count = count;
+        node.maxRank = -1;
+
+        int index = static_cast<int>(nodes.size());
+        nodes.push_back(node);
+        if (count <= leafSize) {
+            for (int k = start; k < start + count; ++k) leafOf[order[k]] = index;
+            return index;
+        }
+
+        bool splitX = node.box.maxX - node.box.minX >= node.box.maxY - node.box.minY;
+        const vector<Box>& b = boxes;
+        vector<int>::iterator first = order.begin() + start;
+        nth_element(first, first + count / 2, first + count, [&](int i, int j) {
+            return splitX ? b[i].minX + b[i].maxX < b[j].minX + b[j].maxX
+                          : b[i].minY + b[i].maxY < b[j].minY + b[j].maxY;
+        });
+
+        int left = build(start, count / 2, index);
+        int right = build(start + count / 2, count - count / 2, index);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+    }
+};
+
+}  // namespace
+
+ContainmentForest::ContainmentForest(const vector<Shape>& shapes)
+    : parents(shapes.size(), -1), depths(shapes.size(), 0),
+      enter(shapes.size()), leave(shapes.size()) {
+    int n = static_cast<int>(shapes.size());
+
+    // rank[i] — место фигуры при сортировке по убыванию площади
+    vector<double> areas(n);
+    vector<int> byArea(n);
+    for (int i = 0; i < n; ++i) {
+        areas[i] = shapeArea(shapes[i]);
+        byArea[i] = i;
+    }
+    sort(byArea.begin(), byArea.end(), [&](int a, int b) {
+        return areas[a] > areas[b] || (areas[a] == areas[b] && a < b);
+    });
+    vector<int> rank(n);
+    for (int k = 0; k < n; ++k) rank[byArea[k]] = k;
+
+    // Родитель — содержащая фигура с наибольшим рангом среди меньших.
+    // Фигуры добавляются в дерево по возрастанию ранга, так что в момент
+    // поиска в нем ровно фигуры с меньшим рангом
+    RankedTree tree(shapes, rank);
+    for (int k = 0; k < n; ++k) {
+        int i = byArea[k];
+        parents[i] = tree.deepestContainer(i);
+        tree.add(i);
+    }
+
+    // Дети в виде CSR и обход в глубину без рекурсии
+    vector<int> childStart(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        if (parents[i] >= 0) ++childStart[parents[i] + 1];
+        else rootList.push_back(i);
+    }
+    for (int i = 0; i < n; ++i) childStart[i + 1] += childStart[i];
+    vector<int> children(childStart[n]);
+    vector<int> fill(childStart.begin(), childStart.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        if (parents[i] >= 0) children[fill[parents[i]]++] = i;
+    }
+
+    tour.reserve(n);
+    vector<pair<int, int> > stack;  // (узел, следующий ребенок)
+    for (size_t r = 0; r < rootList.size(); ++r) {
+        int rootIndex = rootList[r];
+        enter[rootIndex] = static_cast<int>(tour.size());
+        tour.push_back(rootIndex);
+        stack.push_back(make_pair(rootIndex, childStart[rootIndex]));
+        while (!stack.empty()) {
+            int node = stack.back().first;
+            int& next = stack.back().second;
+            if (next < childStart[node + 1]) {
+                int child = children[next++];
+                depths[child] = depths[node] + 1;
+                enter[child] = static_cast<int>(tour.size());
+                tour.push_back(child);
+                stack.push_back(make_pair(child, childStart[child]));
+            } else {
+                leave[node] = static_cast<int>(tour.size());
+                stack.pop_back();
+            }
+        }
+    }
+}
+
+vector<int> ContainmentForest::descendants(int i) const {
+    return vector<int>(tour.begin() + enter[i] + 1, tour.begin() + leave[i]);
+}
@@ -0,0 +1,45 @@
+#ifndef NESTING_H
+#define NESTING_H
+
+#include "spatial.h"
+#include <cstddef>
+#include <vector>
+
+double shapeArea(const Shape& shape);
+// outer содержит inner (isCircleInCircle, isSquareInSquare,
+// isSquareInCircle, isCircleInSquare)
+bool shapeContains(const Shape& outer, const Shape& inner);
+
+// Дерево вложенности сцены: родитель фигуры — наименьшая по площади
+// фигура, которая ее содержит. Фигуры обрабатываются по убыванию площади
+// (circleArea / squareArea), родитель ищется в дереве прямоугольников
+// уже обработанных фигур с отсечением по прямоугольнику и по площади.
+// Построение — около O(n log n) и для разреженных сцен, и для длинных
+// цепочек вложенных фигур; дольше оно только там, где много больших фигур
+// накрывают фигуру прямоугольником, но не содержат ее.
+// Из одинаковых фигур родителем считается фигура с меньшим индексом.
+class ContainmentForest {
+public:
+    explicit ContainmentForest(const std::vector<Shape>& shapes);
+
+    // -1 у корней
+    int parent(int i) const { return parents[i]; }
+    // Глубина вложенности, 0 у корней; O(1)
+    int depth(int i) const { return depths[i]; }
+    // Лежит ли b (строго) внутри поддерева a; O(1)
+    bool isAncestor(int a, int b) const { return enter[a] < enter[b] && enter[b] < leave[a]; }
+    // Число потомков; O(1)
+    size_t descendantCount(int i) const { return leave[i] - enter[i] - 1; }
+    // Все потомки i в порядке обхода в глубину; O(k)
+    std::vector<int> descendants(int i) const;
+    const std::vector<int>& roots() const { return rootList; }
+
+private:
+    std::vector<int> parents;
+    std::vector<int> depths;
+    std::vector<int> enter, leave;  // отрезок поддерева в tour
+    std::vector<int> tour;
+    std::vector<int> rootList;
+};
+
+#endif
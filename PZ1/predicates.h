@@ -0,0 +1,290 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "structs.h"
+#include <cmath>
+#include <limits>
+
+// Шаблонные версии предикатов из func.h для float и double.
+// Расстояния сравниваются в квадратах, без sqrt; условия собираются через
+// & и |, чтобы компилятор мог обойтись без ветвлений.
+//
+// Политика погрешности задает допуск eps для величин масштаба scale:
+//   equal(a, b)       <=> |a - b| < eps  или  a == b
+//   lessOrEqual(a, b) <=> a < b          или  equal(a, b)
+// При eps > 0 это в точности equal / lessOrEqual из прежнего func.cpp.
+//
+// Когда квадрат расстояния попадает в узкую полосу вокруг квадрата порога,
+// ответ зависит от округления. Тогда он досчитывается через sqrt той же
+// формулой, что была в func.cpp, поэтому при AbsoluteTolerance и double
+// результаты совпадают с прежними. Эта ветка редкая и хорошо предсказывается.
+
+// Абсолютная погрешность EPS = 1e-5, как в func.cpp
+struct AbsoluteTolerance {
+    template <typename T>
+    static T eps(T) { return T(1e-5); }
+};
+
+// Погрешность пропорциональна модулю координат
+struct RelativeTolerance {
+    template <typename T>
+    static T eps(T scale) { return scale * T(64) * std::numeric_limits<T>::epsilon(); }
+};
+
+// Точное сравнение
+struct ExactTolerance {
+    template <typename T>
+    static T eps(T) { return T(0); }
+};
+
+template <typename T>
+struct BasicPoint {
+    T x;
+    T y;
+};
+
+template <typename T>
+struct BasicCircle {
+    BasicPoint<T> center;
+    T radius;
+};
+
+template <typename T>
+struct BasicSquare {
+    BasicPoint<T> topLeft;
+    T side;
+};
+
+inline BasicPoint<double> basic(const Point& p) {
+    BasicPoint<double> b = {p.x, p.y};
+    return b;
+}
+
+inline BasicCircle<double> basic(const Circle& c) {
+    BasicCircle<double> b = {{c.center.x, c.center.y}, c.radius};
+    return b;
+}
+
+inline BasicSquare<double> basic(const Square& s) {
+    BasicSquare<double> b = {{s.topLeft.x, s.topLeft.y}, s.side};
+    return b;
+}
+
+namespace detail {
+
+template <typename T>
+inline T absValue(T v) { return v < 0 ? -v : v; }
+
+template <typename T>
+inline T maxValue(T a, T b) { return a < b ? b : a; }
+
+template <typename T>
+inline T minValue(T a, T b) { return a < b ? a : b; }
+
+template <typename T>
+inline T scaleOf(const BasicPoint<T>& p) { return maxValue(absValue(p.x), absValue(p.y)); }
+
+template <typename T>
+inline bool equal(T a, T b, T eps) { return (absValue(a - b) < eps) | (a == b); }
+
+template <typename T>
+inline bool lessOrEqual(T a, T b, T eps) { return (a < b) | equal(a, b, eps); }
+
+// lessOrEqual(sqrt(d2), s, eps) без корня
+template <typename T>
+inline bool distanceAtMost(T d2, T s, T eps) {
+    T se = s + eps;
+    return ((s >= 0) & (d2 <= s * s)) | ((se > 0) & (d2 < se * se));
+}
+
+// lessOrEqual(a, sqrt(d2), eps) без корня, a >= 0
+template <typename T>
+inline bool distanceAtLeast(T d2, T a, T eps) {
+    T ae = a - eps;
+    return (d2 >= a * a) | (ae < 0) | (d2 > ae * ae);
+}
+
+// d2 в полосе округления вокруг s * s; magnitude — масштаб величин,
+// из которых получен порог s
+template <typename T>
+inline bool nearThreshold(T d2, T s, T magnitude) {
+    return absValue(d2 - s * s) <= T(64) * std::numeric_limits<T>::epsilon() * (d2 + magnitude * magnitude);
+}
+
+template <typename T>
+inline T distance2(const BasicPoint<T>& a, const BasicPoint<T>& b) {
+    T dx = a.x - b.x;
+    T dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+}
+
+// Принадлежность точки кругу (строго внутри)
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isPointInCircle(const BasicPoint<T>& p, const BasicCircle<T>& c) {
+    T eps = Tol::eps(detail::maxValue(detail::maxValue(detail::scaleOf(p), detail::scaleOf(c.center)), c.radius));
+    T d2 = detail::distance2(p, c.center);
+    // d < r && !equal(d, r)  <=>  d <= r - eps (при eps > 0), d < r (при eps = 0)
+    T t = c.radius - eps;
+    if (detail::nearThreshold(d2, t, detail::absValue(c.radius) + eps)) {
+        T d = std::sqrt(d2);
+        return (d < c.radius) & !detail::equal(d, c.radius, eps);
+    }
+    return (t >= 0) & (d2 < t * t);
+}
+
+// Принадлежность точки квадрату (строго внутри)
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isPointInSquare(const BasicPoint<T>& p, const BasicSquare<T>& s) {
+    T right = s.topLeft.x + s.side;
+    T bottom = s.topLeft.y - s.side;
+    return (p.x > s.topLeft.x) & (p.x < right) & (p.y < s.topLeft.y) & (p.y > bottom);
+}
+
+// Точка на круге
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isPointOnCircle(const BasicPoint<T>& p, const BasicCircle<T>& c) {
+    T eps = Tol::eps(detail::maxValue(detail::maxValue(detail::scaleOf(p), detail::scaleOf(c.center)), c.radius));
+    T d2 = detail::distance2(p, c.center);
+    // equal(d, r)  <=>  r - eps < d < r + eps  или  d == r
+    T hi = c.radius + eps;
+    T lo = c.radius - eps;
+    T magnitude = detail::absValue(c.radius) + eps;
+    if (detail::nearThreshold(d2, hi, magnitude) | detail::nearThreshold(d2, lo, magnitude)) {
+        return detail::equal(std::sqrt(d2), c.radius, eps);
+    }
+    return (hi > 0) & (d2 < hi * hi) & ((lo < 0) | (d2 > lo * lo));
+}
+
+// Точка на квадрате
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isPointOnSquare(const BasicPoint<T>& p, const BasicSquare<T>& s) {
+    T eps = Tol::eps(detail::maxValue(detail::maxValue(detail::scaleOf(p), detail::scaleOf(s.topLeft)), s.side));
+    T right = s.topLeft.x + s.side;
+    T bottom = s.topLeft.y - s.side;
+
+    bool spanY = detail::lessOrEqual(p.y, s.topLeft.y, eps) & detail::lessOrEqual(bottom, p.y, eps);
+    bool spanX = detail::lessOrEqual(s.topLeft.x, p.x, eps) & detail::lessOrEqual(p.x, right, eps);
+    bool vertical = (detail::equal(p.x, s.topLeft.x, eps) | detail::equal(p.x, right, eps)) & spanY;
+    bool horizontal = (detail::equal(p.y, s.topLeft.y, eps) | detail::equal(p.y, bottom, eps)) & spanX;
+    return vertical | horizontal;
+}
+
+// Пересечение двух кругов
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool circlesIntersect(const BasicCircle<T>& c1, const BasicCircle<T>& c2) {
+    T scale = detail::maxValue(detail::maxValue(detail::scaleOf(c1.center), detail::scaleOf(c2.center)),
+                               detail::maxValue(c1.radius, c2.radius));
+    T eps = Tol::eps(scale);
+    T d2 = detail::distance2(c1.center, c2.center);
+    T sum = c1.radius + c2.radius;
+    T diff = detail::absValue(c1.radius - c2.radius);
+    T magnitude = detail::absValue(c1.radius) + detail::absValue(c2.radius) + eps;
+    if (detail::nearThreshold(d2, sum, magnitude) | detail::nearThreshold(d2, sum + eps, magnitude) |
+        detail::nearThreshold(d2, diff, magnitude) | detail::nearThreshold(d2, diff - eps, magnitude)) {
+        T d = std::sqrt(d2);
+        return detail::lessOrEqual(d, sum, eps) & detail::lessOrEqual(diff, d, eps);
+    }
+    return detail::distanceAtMost(d2, sum, eps) & detail::distanceAtLeast(d2, diff, eps);
+}
+
+// Пересечение двух квадратов
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool squaresIntersect(const BasicSquare<T>& s1, const BasicSquare<T>& s2) {
+    T right1 = s1.topLeft.x + s1.side;
+    T bottom1 = s1.topLeft.y - s1.side;
+    T right2 = s2.topLeft.x + s2.side;
+    T bottom2 = s2.topLeft.y - s2.side;
+    return !((right1 <= s2.topLeft.x) | (s1.topLeft.x >= right2) |
+             (bottom1 >= s2.topLeft.y) | (s1.topLeft.y <= bottom2));
+}
+
+// Пересечение круга и квадрата: ближайшая к центру точка квадрата.
+// Проверка углов из func.cpp ею поглощается (угол в круге — значит, и
+// ближайшая точка в круге) и нужна только на границе из-за округления.
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool circleSquareIntersect(const BasicCircle<T>& c, const BasicSquare<T>& s) {
+    T right = s.topLeft.x + s.side;
+    T bottom = s.topLeft.y - s.side;
+    T closestX = detail::maxValue(s.topLeft.x, detail::minValue(c.center.x, right));
+    T closestY = detail::minValue(s.topLeft.y, detail::maxValue(c.center.y, bottom));
+    T dx = closestX - c.center.x;
+    T dy = closestY - c.center.y;
+    T d2 = dx * dx + dy * dy;
+    T r2 = c.radius * c.radius;
+    if ((d2 > r2) & (c.radius >= 0) && detail::nearThreshold(d2, c.radius, c.radius)) {
+        T xs[2] = {s.topLeft.x - c.center.x, right - c.center.x};
+        T ys[2] = {s.topLeft.y - c.center.y, bottom - c.center.y};
+        for (int i = 0; i < 2; ++i) {
+            for (int j = 0; j < 2; ++j) {
+                if (std::sqrt(xs[i] * xs[i] + ys[j] * ys[j]) <= c.radius) return true;
+            }
+        }
+    }
+    return d2 <= r2;
+}
+
+// Круг внутри круга
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isCircleInCircle(const BasicCircle<T>& c1, const BasicCircle<T>& c2) {
+    T scale = detail::maxValue(detail::maxValue(detail::scaleOf(c1.center), detail::scaleOf(c2.center)),
+                               detail::maxValue(c1.radius, c2.radius));
+    T eps = Tol::eps(scale);
+    T d2 = detail::distance2(c1.center, c2.center);
+    // lessOrEqual(d + r1, r2)  <=>  lessOrEqual(d, r2 - r1)
+    T room = c2.radius - c1.radius;
+    T magnitude = detail::absValue(c1.radius) + detail::absValue(c2.radius) + eps;
+    if (detail::nearThreshold(d2, room, magnitude) | detail::nearThreshold(d2, room + eps, magnitude)) {
+        return detail::lessOrEqual(std::sqrt(d2) + c1.radius, c2.radius, eps);
+    }
+    return detail::distanceAtMost(d2, room, eps);
+}
+
+// Квадрат внутри квадрата
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isSquareInSquare(const BasicSquare<T>& s1, const BasicSquare<T>& s2) {
+    T right1 = s1.topLeft.x + s1.side;
+    T bottom1 = s1.topLeft.y - s1.side;
+    T right2 = s2.topLeft.x + s2.side;
+    T bottom2 = s2.topLeft.y - s2.side;
+    return (s1.topLeft.x >= s2.topLeft.x) & (right1 <= right2) &
+           (s1.topLeft.y <= s2.topLeft.y) & (bottom1 >= bottom2);
+}
+
+// Квадрат внутри круга: все углы не дальше радиуса
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isSquareInCircle(const BasicSquare<T>& s, const BasicCircle<T>& c) {
+    T xs[2] = {s.topLeft.x - c.center.x, s.topLeft.x + s.side - c.center.x};
+    T ys[2] = {s.topLeft.y - c.center.y, s.topLeft.y - s.side - c.center.y};
+    T r2 = c.radius * c.radius;
+    bool inside = c.radius >= 0;
+    bool boundary = false;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            T d2 = xs[i] * xs[i] + ys[j] * ys[j];
+            inside &= d2 <= r2;
+            boundary |= detail::nearThreshold(d2, c.radius, c.radius);
+        }
+    }
+    if (boundary & (c.radius >= 0)) {
+        for (int i = 0; i < 2; ++i) {
+            for (int j = 0; j < 2; ++j) {
+                if (std::sqrt(xs[i] * xs[i] + ys[j] * ys[j]) > c.radius) return false;
+            }
+        }
+        return true;
+    }
+    return inside;
+}
+
+// Круг внутри квадрата
+template <typename Tol = AbsoluteTolerance, typename T>
+inline bool isCircleInSquare(const BasicCircle<T>& c, const BasicSquare<T>& s) {
+    T right = s.topLeft.x + s.side;
+    T bottom = s.topLeft.y - s.side;
+    return (c.center.x - c.radius >= s.topLeft.x) & (c.center.x + c.radius <= right) &
+           (c.center.y - c.radius >= bottom) & (c.center.y + c.radius <= s.topLeft.y);
+}
+
+#endif
@@ -0,0 +1,927 @@
+// Проверка оптимизированных версий против простых скалярных:
+//  - func.h (шаблоны predicates.h без sqrt) против прямых формул через sqrt,
+//    а также шаблоны для float с AbsoluteTolerance и для double с
+//    RelativeTolerance против тех же формул с тем же допуском
+//  - пакетные ядра batch.h против func.h
+//  - fixed.h против predicates.h с точным сравнением на целых координатах
+//    и на значениях у границ допустимого диапазона
+//  - sweepAndPrune, UniformGrid, BVH, DynamicBVH, PointLocator,
+//    ContainmentForest, unionAreaExact и unionAreaApprox против полного
+//    перебора
+//  - пакетный режим structs --batch против перебора (нужен собранный
+//    ./structs, make test собирает его сам)
+#include "batch.h"
+#include "coverage.h"
+#include "dynbvh.h"
+#include "fixed.h"
+#include "func.h"
+#include "locate.h"
+#include "nesting.h"
+#include "predicates.h"
+#include "shapeio.h"
+#include "spatial.h"
+#include "sweep.h"
+#include "workload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace reference {
+
+// Прямые формулы через sqrt. Допуск eps считается политикой Tol от того же
+// масштаба, что и в predicates.h
+template <typename Tol, typename T>
+struct Tolerance {
+    T eps;
+
+    explicit Tolerance(T scale) : eps(Tol::eps(scale)) {}
+    bool equal(T a, T b) const { return std::fabs(a - b) < eps || a == b; }
+    bool lessOrEqual(T a, T b) const { return a < b || equal(a, b); }
+};
+
+template <typename T>
+T scaleOf(const BasicPoint<T>& p) { return max(std::fabs(p.x), std::fabs(p.y)); }
+
+template <typename T>
+T distance(T x1, T y1, T x2, T y2) {
+    return std::sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
+}
+
+template <typename Tol, typename T>
+bool isPointInCircle(const BasicPoint<T>& p, const BasicCircle<T>& c) {
+    Tolerance<Tol, T> tol(max(max(scaleOf(p), scaleOf(c.center)), c.radius));
+    T d = distance(p.x, p.y, c.center.x, c.center.y);
+    return d < c.radius && !tol.equal(d, c.radius);
+}
+
+template <typename Tol, typename T>
+bool isPointInSquare(const BasicPoint<T>& p, const BasicSquare<T>& s) {
+    return p.x > s.topLeft.x && p.x < s.topLeft.x + s.side && p.y < s.topLeft.y && p.y > s.topLeft.y - s.side;
+}
+
+template <typename Tol, typename T>
+bool isPointOnCircle(const BasicPoint<T>& p, const BasicCircle<T>& c) {
+    Tolerance<Tol, T> tol(max(max(scaleOf(p), scaleOf(c.center)), c.radius));
+    return tol.equal(distance(p.x, p.y, c.center.x, c.center.y), c.radius);
+}
+
+template <typename Tol, typename T>
+bool isPointOnSquare(const BasicPoint<T>& p, const BasicSquare<T>& s) {
+    Tolerance<Tol, T> tol(max(max(scaleOf(p), scaleOf(s.topLeft)), s.side));
+    T right = s.topLeft.x + s.side;
+    T bottom = s.topLeft.y - s.side;
+    bool spanY = tol.lessOrEqual(p.y, s.topLeft.y) && tol.lessOrEqual(bottom, p.y);
+    bool spanX = tol.lessOrEqual(s.topLeft.x, p.x) && tol.lessOrEqual(p.x, right);
+    return ((tol.equal(p.x, s.topLeft.x) || tol.equal(p.x, right)) && spanY) ||
+           ((tol.equal(p.y, s.topLeft.y) || tol.equal(p.y, bottom)) && spanX);
+}
+
+template <typename Tol, typename T>
+bool circlesIntersect(const BasicCircle<T>& a, const BasicCircle<T>& b) {
+    Tolerance<Tol, T> tol(max(max(scaleOf(a.center), scaleOf(b.center)), max(a.radius, b.radius)));
+    T d = distance(a.center.x, a.center.y, b.center.x, b.center.y);
+    return tol.lessOrEqual(d, a.radius + b.radius) && tol.lessOrEqual(std::fabs(a.radius - b.radius), d);
+}
+
+template <typename Tol, typename T>
+bool squaresIntersect(const BasicSquare<T>& a, const BasicSquare<T>& b) {
+    return !(a.topLeft.x + a.side <= b.topLeft.x || a.topLeft.x >= b.topLeft.x + b.side ||
+             a.topLeft.y - a.side >= b.topLeft.y || a.topLeft.y <= b.topLeft.y - b.side);
+}
+
+template <typename Tol, typename T>
+bool circleSquareIntersect(const BasicCircle<T>& c, const BasicSquare<T>& s) {
+    T xs[2] = {s.topLeft.x, s.topLeft.x + s.side};
+    T ys[2] = {s.topLeft.y, s.topLeft.y - s.side};
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 2; ++j)
+            if (distance(xs[i], ys[j], c.center.x, c.center.y) <= c.radius) return true;
+    T closestX = max(xs[0], min(c.center.x, xs[1]));
+    T closestY = min(ys[0], max(c.center.y, ys[1]));
+    T dx = closestX - c.center.x;
+    T dy = closestY - c.center.y;
+    return dx * dx + dy * dy <= c.radius * c.radius;
+}
+
+template <typename Tol, typename T>
+bool isCircleInCircle(const BasicCircle<T>& a, const BasicCircle<T>& b) {
+    Tolerance<Tol, T> tol(max(max(scaleOf(a.center), scaleOf(b.center)), max(a.radius, b.radius)));
+    return tol.lessOrEqual(distance(a.center.x, a.center.y, b.center.x, b.center.y) + a.radius, b.radius);
+}
+
+template <typename Tol, typename T>
+bool isSquareInSquare(const BasicSquare<T>& a, const BasicSquare<T>& b) {
+    return a.topLeft.x >= b.topLeft.x && a.topLeft.x + a.side <= b.topLeft.x + b.side &&
+           a.topLeft.y <= b.topLeft.y && a.topLeft.y - a.side >= b.topLeft.y - b.side;
+}
+
+template <typename Tol, typename T>
+bool isSquareInCircle(const BasicSquare<T>& s, const BasicCircle<T>& c) {
+    T xs[2] = {s.topLeft.x, s.topLeft.x + s.side};
+    T ys[2] = {s.topLeft.y, s.topLeft.y - s.side};
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 2; ++j)
+            if (distance(xs[i], ys[j], c.center.x, c.center.y) > c.radius) return false;
+    return true;
+}
+
+template <typename Tol, typename T>
+bool isCircleInSquare(const BasicCircle<T>& c, const BasicSquare<T>& s) {
+    return c.center.x - c.radius >= s.topLeft.x && c.center.x + c.radius <= s.topLeft.x + s.side &&
+           c.center.y - c.radius >= s.topLeft.y - s.side && c.center.y + c.radius <= s.topLeft.y;
+}
+
+// Для func.h: double и абсолютный допуск EPS
+#define REFERENCE_FOR_FUNC(name, A, B) \
+    bool name(const A& a, const B& b) { return reference::name<AbsoluteTolerance>(basic(a), basic(b)); }
+
+REFERENCE_FOR_FUNC(isPointInCircle, Point, Circle)
+REFERENCE_FOR_FUNC(isPointInSquare, Point, Square)
+REFERENCE_FOR_FUNC(isPointOnCircle, Point, Circle)
+REFERENCE_FOR_FUNC(isPointOnSquare, Point, Square)
+REFERENCE_FOR_FUNC(circlesIntersect, Circle, Circle)
+REFERENCE_FOR_FUNC(squaresIntersect, Square, Square)
+REFERENCE_FOR_FUNC(circleSquareIntersect, Circle, Square)
+REFERENCE_FOR_FUNC(isCircleInCircle, Circle, Circle)
+REFERENCE_FOR_FUNC(isSquareInSquare, Square, Square)
+REFERENCE_FOR_FUNC(isSquareInCircle, Square, Circle)
+REFERENCE_FOR_FUNC(isCircleInSquare, Circle, Square)
+
+}  // namespace reference
+
+namespace {
+
+int failures = 0;
+
+void check(const char* name, const char* what, size_t mismatches, size_t total) {
+    if (mismatches) ++failures;
+    printf("%-4s %-24s %-26s %zu/%zu\n", mismatches ? "FAIL" : "ok", name, what, mismatches, total);
+}
+
+template <typename A, typename B, typename F, typename G>
+void compare(const char* name, const string& what, const vector<A>& a, const vector<B>& b, F tested, G expected) {
+    size_t bad = 0;
+    for (size_t i = 0; i < a.size(); ++i) bad += tested(a[i], b[i]) != expected(a[i], b[i]);
+    check(name, what.c_str(), bad, a.size());
+}
+
+#define COMPARE(name, kind, a, b, A, B)                                              \
+    compare(#name, WORKLOAD_NAMES[kind], a, b, [](const A& x, const B& y) { return name(x, y); }, \
+            [](const A& x, const B& y) { return reference::name(x, y); })
+
+void scalarAgainstReference(Workload kind, size_t n) {
+    WorkloadGenerator gen(kind, 100 + kind);
+    vector<Point> pc, ps;
+    vector<Circle> circles, nearCircle, circlesNearSquare;
+    vector<Square> squares, nearSquare, squaresNearCircle;
+    for (size_t i = 0; i < n; ++i) {
+        circles.push_back(gen.circle());
+        squares.push_back(gen.square());
+        pc.push_back(gen.pointNear(circles.back()));
+        ps.push_back(gen.pointNear(squares.back()));
+        nearCircle.push_back(gen.circleNear(circles.back()));
+        nearSquare.push_back(gen.squareNear(squares.back()));
+        circlesNearSquare.push_back(gen.circleNear(squares.back()));
+        squaresNearCircle.push_back(gen.squareNear(circles.back()));
+    }
+    COMPARE(isPointInCircle, kind, pc, circles, Point, Circle);
+    COMPARE(isPointInSquare, kind, ps, squares, Point, Square);
+    COMPARE(isPointOnCircle, kind, pc, circles, Point, Circle);
+    COMPARE(isPointOnSquare, kind, ps, squares, Point, Square);
+    COMPARE(circlesIntersect, kind, nearCircle, circles, Circle, Circle);
+    COMPARE(squaresIntersect, kind, nearSquare, squares, Square, Square);
+    COMPARE(circleSquareIntersect, kind, circlesNearSquare, squares, Circle, Square);
+    COMPARE(isCircleInCircle, kind, nearCircle, circles, Circle, Circle);
+    COMPARE(isSquareInSquare, kind, nearSquare, squares, Square, Square);
+    COMPARE(isSquareInCircle, kind, squaresNearCircle, circles, Square, Circle);
+    COMPARE(isCircleInSquare, kind, circlesNearSquare, squares, Circle, Square);
+}
+
+template <typename T>
+BasicPoint<T> convert(const Point& p) {
+    BasicPoint<T> b = {T(p.x), T(p.y)};
+    return b;
+}
+
+template <typename T>
+BasicCircle<T> convert(const Circle& c) {
+    BasicCircle<T> b = {convert<T>(c.center), T(c.radius)};
+    return b;
+}
+
+template <typename T>
+BasicSquare<T> convert(const Square& s) {
+    BasicSquare<T> b = {convert<T>(s.topLeft), T(s.side)};
+    return b;
+}
+
+#define COMPARE_TOLERANCE(name, what, a, b, A, B)                                           \
+    compare(#name, what, a, b, [](const A& x, const B& y) { return name<Tol>(x, y); }, \
+            [](const A& x, const B& y) { return reference::name<Tol>(x, y); })
+
+// Шаблоны predicates.h с другими типом и политикой допуска против прямых
+// формул с той же политикой
+template <typename Tol, typename T>
+void templatesAgainstReference(const char* variant, Workload kind, size_t n) {
+    typedef BasicPoint<T> P;
+    typedef BasicCircle<T> C;
+    typedef BasicSquare<T> S;
+    WorkloadGenerator gen(kind, 150 + kind);
+    vector<P> pc, ps;
+    vector<C> circles, nearCircle, circlesNearSquare;
+    vector<S> squares, nearSquare, squaresNearCircle;
+    for (size_t i = 0; i < n; ++i) {
+        Circle c = gen.circle();
+        Square s = gen.square();
+        circles.push_back(convert<T>(c));
+        squares.push_back(convert<T>(s));
+        pc.push_back(convert<T>(gen.pointNear(c)));
+        ps.push_back(convert<T>(gen.pointNear(s)));
+        nearCircle.push_back(convert<T>(gen.circleNear(c)));
+        nearSquare.push_back(convert<T>(gen.squareNear(s)));
+        circlesNearSquare.push_back(convert<T>(gen.circleNear(s)));
+        squaresNearCircle.push_back(convert<T>(gen.squareNear(c)));
+    }
+    string what = string(variant) + " " + WORKLOAD_NAMES[kind];
+    COMPARE_TOLERANCE(isPointInCircle, what, pc, circles, P, C);
+    COMPARE_TOLERANCE(isPointInSquare, what, ps, squares, P, S);
+    COMPARE_TOLERANCE(isPointOnCircle, what, pc, circles, P, C);
+    COMPARE_TOLERANCE(isPointOnSquare, what, ps, squares, P, S);
+    COMPARE_TOLERANCE(circlesIntersect, what, nearCircle, circles, C, C);
+    COMPARE_TOLERANCE(squaresIntersect, what, nearSquare, squares, S, S);
+    COMPARE_TOLERANCE(circleSquareIntersect, what, circlesNearSquare, squares, C, S);
+    COMPARE_TOLERANCE(isCircleInCircle, what, nearCircle, circles, C, C);
+    COMPARE_TOLERANCE(isSquareInSquare, what, nearSquare, squares, S, S);
+    COMPARE_TOLERANCE(isSquareInCircle, what, squaresNearCircle, circles, S, C);
+    COMPARE_TOLERANCE(isCircleInSquare, what, circlesNearSquare, squares, C, S);
+}
+
+// Оба вида пакетных вызовов против поэлементных
+template <typename Batch, typename ShapeT>
+void batchAgainstScalar(const char* name, Workload kind, const vector<Point>& points, const vector<ShapeT>& shapes,
+                        void (*pointsKernel)(const PointBatch&, const ShapeT&, uint64_t*),
+                        void (*shapesKernel)(const Point&, const Batch&, uint64_t*),
+                        bool (*scalar)(const Point&, const ShapeT&)) {
+    PointBatch pointBatch;
+    Batch shapeBatch;
+    for (size_t i = 0; i < points.size(); ++i) pointBatch.push(points[i]);
+    for (size_t i = 0; i < shapes.size(); ++i) shapeBatch.push(shapes[i]);
+
+    size_t bad = 0, total = 0;
+    vector<uint64_t> mask(maskWords(max(points.size(), shapes.size())));
+    for (size_t s = 0; s < shapes.size(); s += 97) {
+        pointsKernel(pointBatch, shapes[s], mask.data());
+        for (size_t i = 0; i < points.size(); ++i, ++total) bad += maskTest(mask.data(), i) != scalar(points[i], shapes[s]);
+    }
+    for (size_t p = 0; p < points.size(); p += 97) {
+        shapesKernel(points[p], shapeBatch, mask.data());
+        for (size_t i = 0; i < shapes.size(); ++i, ++total) bad += maskTest(mask.data(), i) != scalar(points[p], shapes[i]);
+    }
+    check(name, (string("batch ") + WORKLOAD_NAMES[kind]).c_str(), bad, total);
+}
+
+void batchAgainstScalar(Workload kind, size_t n) {
+    WorkloadGenerator gen(kind, 200 + kind);
+    vector<Circle> circles;
+    vector<Square> squares;
+    vector<Point> points;
+    // Длина не кратна 4, чтобы проверить и хвост
+    for (size_t i = 0; i < n + 3; ++i) {
+        circles.push_back(gen.circle());
+        squares.push_back(gen.square());
+        points.push_back(i % 2 ? gen.pointNear(circles[i / 2]) : gen.pointNear(squares[i / 2]));
+    }
+    batchAgainstScalar<CircleBatch, Circle>("isPointInCircle", kind, points, circles, isPointInCircle,
+                                            isPointInCircle, isPointInCircle);
+    batchAgainstScalar<SquareBatch, Square>("isPointInSquare", kind, points, squares, isPointInSquare,
+                                            isPointInSquare, isPointInSquare);
+    batchAgainstScalar<CircleBatch, Circle>("isPointOnCircle", kind, points, circles, isPointOnCircle,
+                                            isPointOnCircle, isPointOnCircle);
+    batchAgainstScalar<SquareBatch, Square>("isPointOnSquare", kind, points, squares, isPointOnSquare,
+                                            isPointOnSquare, isPointOnSquare);
+}
+
+// На небольших целых координатах double-шаблоны с ExactTolerance считают
+// точно, и ответы fixed.h должны с ними совпадать
+const char* const PREDICATE_NAMES[] = {
+    "isPointInCircle", "isPointInSquare", "isPointOnCircle", "isPointOnSquare",
+    "circlesIntersect", "squaresIntersect", "circleSquareIntersect", "isCircleInCircle",
+    "isSquareInSquare", "isSquareInCircle", "isCircleInSquare"};
+
+#define COMPARE_FIXED(index, name, a, b, A, B) bad[index] += name(A, B) != name<ExactTolerance>(basic(a), basic(b))
+
+template <typename I>
+void fixedAgainstExact(const char* type, size_t n) {
+    mt19937 random(300);
+    uniform_int_distribution<int> coord(-12, 12), size(0, 10);
+    size_t bad[11] = {0};
+    for (size_t i = 0; i < n; ++i) {
+        Point p = {double(coord(random)), double(coord(random))};
+        Circle c1 = {{double(coord(random)), double(coord(random))}, double(size(random))};
+        Circle c2 = {{double(coord(random)), double(coord(random))}, double(size(random))};
+        Square s1 = {{double(coord(random)), double(coord(random))}, double(size(random))};
+        Square s2 = {{double(coord(random)), double(coord(random))}, double(size(random))};
+        FixedPoint<I> fp = toFixed<I>(p, 1);
+        FixedCircle<I> fc1 = toFixed<I>(c1, 1), fc2 = toFixed<I>(c2, 1);
+        FixedSquare<I> fs1 = toFixed<I>(s1, 1), fs2 = toFixed<I>(s2, 1);
+        COMPARE_FIXED(0, isPointInCircle, p, c1, fp, fc1);
+        COMPARE_FIXED(1, isPointInSquare, p, s1, fp, fs1);
+        COMPARE_FIXED(2, isPointOnCircle, p, c1, fp, fc1);
+        COMPARE_FIXED(3, isPointOnSquare, p, s1, fp, fs1);
+        COMPARE_FIXED(4, circlesIntersect, c1, c2, fc1, fc2);
+        COMPARE_FIXED(5, squaresIntersect, s1, s2, fs1, fs2);
+        COMPARE_FIXED(6, circleSquareIntersect, c1, s1, fc1, fs1);
+        COMPARE_FIXED(7, isCircleInCircle, c1, c2, fc1, fc2);
+        COMPARE_FIXED(8, isSquareInSquare, s1, s2, fs1, fs2);
+        COMPARE_FIXED(9, isSquareInCircle, s1, c1, fs1, fc1);
+        COMPARE_FIXED(10, isCircleInSquare, c1, s1, fc1, fs1);
+    }
+    for (int i = 0; i < 11; ++i) check(PREDICATE_NAMES[i], type, bad[i], n);
+}
+
+// Значения у самых границ допустимого диапазона fixed.h. Для int32_t эталон —
+// те же фигуры в int64_t (Wide = __int128 считает точно). Предикаты
+// однородны, поэтому фигуры int32_t, умноженные на 2^32, проверяют int64_t
+// у его границы 2^61.
+template <typename I>
+I nearLimit(mt19937_64& random, I limit) {
+    const I fixedValues[] = {I(-limit), I(-limit / 2), 0, I(limit / 2), limit};
+    if (random() % 2) return fixedValues[random() % 5];
+    return static_cast<I>(static_cast<int64_t>(random() % (2 * uint64_t(limit) + 1)) - limit);
+}
+
+template <typename To, typename From>
+FixedPoint<To> scaled(const FixedPoint<From>& p, To k) {
+    FixedPoint<To> f = {To(p.x * k), To(p.y * k)};
+    return f;
+}
+
+template <typename To, typename From>
+FixedCircle<To> scaled(const FixedCircle<From>& c, To k) {
+    FixedCircle<To> f = {scaled(c.center, k), To(c.radius * k)};
+    return f;
+}
+
+template <typename To, typename From>
+FixedSquare<To> scaled(const FixedSquare<From>& s, To k) {
+    FixedSquare<To> f = {scaled(s.topLeft, k), To(s.side * k)};
+    return f;
+}
+
+#define COMPARE_SCALED(index, name, a, b)                                      \
+    bad32[index] += name(a, b) != name(scaled(a, int64_t(1)), scaled(b, int64_t(1))); \
+    bad64[index] += name(a, b) != name(scaled(a, int64_t(1) << 32), scaled(b, int64_t(1) << 32))
+
+void fixedAtLimits(size_t n) {
+    mt19937_64 random(301);
+    const int32_t limit = 1 << 29;
+    size_t bad32[11] = {0}, bad64[11] = {0};
+    for (size_t i = 0; i < n; ++i) {
+        FixedPoint<int32_t> p = {nearLimit(random, limit), nearLimit(random, limit)};
+        FixedCircle<int32_t> c1 = {{nearLimit(random, limit), nearLimit(random, limit)}, abs(nearLimit(random, limit))};
+        FixedCircle<int32_t> c2 = {{nearLimit(random, limit), nearLimit(random, limit)}, abs(nearLimit(random, limit))};
+        FixedSquare<int32_t> s1 = {{nearLimit(random, limit), nearLimit(random, limit)}, abs(nearLimit(random, limit))};
+        FixedSquare<int32_t> s2 = {{nearLimit(random, limit), nearLimit(random, limit)}, abs(nearLimit(random, limit))};
+        COMPARE_SCALED(0, isPointInCircle, p, c1);
+        COMPARE_SCALED(1, isPointInSquare, p, s1);
+        COMPARE_SCALED(2, isPointOnCircle, p, c1);
+        COMPARE_SCALED(3, isPointOnSquare, p, s1);
+        COMPARE_SCALED(4, circlesIntersect, c1, c2);
+        COMPARE_SCALED(5, squaresIntersect, s1, s2);
+        COMPARE_SCALED(6, circleSquareIntersect, c1, s1);
+        COMPARE_SCALED(7, isCircleInCircle, c1, c2);
+        COMPARE_SCALED(8, isSquareInSquare, s1, s2);
+        COMPARE_SCALED(9, isSquareInCircle, s1, c1);
+        COMPARE_SCALED(10, isCircleInSquare, c1, s1);
+    }
+    for (int i = 0; i < 11; ++i) check(PREDICATE_NAMES[i], "fixed32 at 2^29", bad32[i], n);
+    for (int i = 0; i < 11; ++i) check(PREDICATE_NAMES[i], "fixed64 at 2^61", bad64[i], n);
+}
+
+vector<Shape> randomScene(size_t n, unsigned seed) {
+    mt19937 random(seed);
+    uniform_real_distribution<double> coord(0, 200), size(0.5, 6);
+    vector<Shape> shapes;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 2) {
+            Circle c = {{coord(random), coord(random)}, size(random)};
+            shapes.push_back(makeShape(c));
+        } else {
+            Square s = {{coord(random), coord(random)}, size(random)};
+            shapes.push_back(makeShape(s));
+        }
+    }
+    return shapes;
+}
+
+bool samePairs(vector<ShapePair> pairs, const vector<ShapePair>& expected) {
+    for (size_t i = 0; i < pairs.size(); ++i)
+        if (pairs[i].first > pairs[i].second) swap(pairs[i].first, pairs[i].second);
+    sort(pairs.begin(), pairs.end(), [](const ShapePair& a, const ShapePair& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    });
+    if (pairs.size() != expected.size()) return false;
+    for (size_t i = 0; i < pairs.size(); ++i)
+        if (pairs[i].first != expected[i].first || pairs[i].second != expected[i].second) return false;
+    return true;
+}
+
+void indexesAgainstBruteForce(size_t n) {
+    vector<Shape> shapes = randomScene(n, 400);
+    int count = static_cast<int>(shapes.size());
+
+    vector<ShapePair> expected;
+    for (int i = 0; i < count; ++i)
+        for (int j = i + 1; j < count; ++j)
+            if (shapesIntersect(shapes[i], shapes[j])) expected.push_back(ShapePair{i, j});
+    check("UniformGrid::allPairs", "pairs", !samePairs(UniformGrid(shapes).allPairs(), expected), 1);
+    check("BVH::allPairs", "pairs", !samePairs(BVH(shapes).allPairs(), expected), 1);
+    check("sweepAndPrune", "pairs", !samePairs(sweepAndPrune(shapes, 4), expected), 1);
+    vector<ShapePair> streamed;
+    sweepAndPrune(shapes, [&](const ShapePair* pairs, size_t n) { streamed.insert(streamed.end(), pairs, pairs + n); }, 4);
+    check("sweepAndPrune", "callback pairs", !samePairs(streamed, expected), 1);
+
+    mt19937 random(401);
+    uniform_real_distribution<double> coord(-5, 205);
+    vector<Point> points;
+    for (size_t i = 0; i < n; ++i) points.push_back(Point{coord(random), coord(random)});
+
+    UniformGrid grid(shapes);
+    BVH bvh(shapes);
+    vector<Shape> probes = randomScene(n / 4, 402);
+    size_t gridBad = 0, bvhBad = 0;
+    for (size_t q = 0; q < probes.size(); ++q) {
+        vector<int> want;
+        for (int i = 0; i < count; ++i)
+            if (shapesIntersect(probes[q], shapes[i])) want.push_back(i);
+        vector<int> got = grid.query(probes[q]);
+        sort(got.begin(), got.end());
+        gridBad += got != want;
+        got = bvh.query(probes[q]);
+        sort(got.begin(), got.end());
+        bvhBad += got != want;
+    }
+    check("UniformGrid::query", "shapes", gridBad, probes.size());
+    check("BVH::query", "shapes", bvhBad, probes.size());
+
+    PointLocator locator(shapes);
+    vector<int> offsets, hits;
+    locator.queryBatch(points, offsets, hits, 4);
+    size_t bad = 0;
+    for (size_t q = 0; q < points.size(); ++q) {
+        vector<int> want;
+        for (int i = 0; i < count; ++i) {
+            bool inside = shapes[i].kind == Shape::CIRCLE ? isPointInCircle(points[q], shapes[i].circle)
+                                                          : isPointInSquare(points[q], shapes[i].square);
+            if (inside) want.push_back(i);
+        }
+        vector<int> got(hits.begin() + offsets[q], hits.begin() + offsets[q + 1]);
+        sort(got.begin(), got.end());
+        bad += got != want;
+    }
+    check("PointLocator", "queryBatch", bad, points.size());
+
+    const size_t k = 5;
+    vector<Neighbor> nearest = bvh.nearestBatch(points, k, 4);
+    bad = 0;
+    for (size_t q = 0; q < points.size(); ++q) {
+        vector<double> distances;
+        for (int i = 0; i < count; ++i) distances.push_back(distanceToShape(points[q], shapes[i]));
+        sort(distances.begin(), distances.end());
+        for (size_t j = 0; j < k; ++j) bad += nearest[q * k + j].distance != distances[j];
+    }
+    check("BVH::nearestBatch", "distances", bad, points.size() * k);
+
+    const double radius = 4;
+    vector<int> radiusOffsets;
+    vector<Neighbor> radiusHits;
+    bvh.withinRadiusBatch(points, radius, radiusOffsets, radiusHits, 4);
+    size_t singleBad = 0, batchBad = 0;
+    for (size_t q = 0; q < points.size(); ++q) {
+        vector<Neighbor> want;
+        for (int i = 0; i < count; ++i) {
+            double d = distanceToShape(points[q], shapes[i]);
+            if (d <= radius) want.push_back(Neighbor{i, d});
+        }
+        sort(want.begin(), want.end(), [](const Neighbor& a, const Neighbor& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+        });
+        vector<Neighbor> got = bvh.withinRadius(points[q], radius);
+        bool same = got.size() == want.size();
+        for (size_t j = 0; same && j < got.size(); ++j)
+            same = got[j].index == want[j].index && got[j].distance == want[j].distance;
+        singleBad += !same;
+        same = static_cast<size_t>(radiusOffsets[q + 1] - radiusOffsets[q]) == got.size();
+        for (size_t j = 0; same && j < got.size(); ++j)
+            same = radiusHits[radiusOffsets[q] + j].index == got[j].index;
+        batchBad += !same;
+    }
+    check("BVH::withinRadius", "neighbors", singleBad, points.size());
+    check("BVH::withinRadiusBatch", "neighbors", batchBad, points.size());
+
+    ContainmentForest forest(shapes);
+    bad = 0;
+    for (int i = 0; i < count; ++i) {
+        double area = shapeArea(shapes[i]);
+        int parent = -1;
+        double parentArea = 0;
+        for (int j = 0; j < count; ++j) {
+            double other = shapeArea(shapes[j]);
+            bool earlier = other > area || (other == area && j < i);
+            if (j == i || !earlier || !shapeContains(shapes[j], shapes[i])) continue;
+            if (parent < 0 || other < parentArea || (other == parentArea && j > parent)) {
+                parent = j;
+                parentArea = other;
+            }
+        }
+        bad += forest.parent(i) != parent;
+    }
+    check("ContainmentForest", "parents", bad, count);
+}
+
+// Цепочка концентрических кругов, от большего к меньшему. Родитель —
+// соседний круг, а время построения при росте цепочки в 4 раза должно
+// расти почти линейно (квадратичное — в 16 раз)
+vector<Shape> nestedChain(int n) {
+    vector<Shape> shapes;
+    for (int i = 0; i < n; ++i) {
+        Circle c = {{0, 0}, 1 + 0.01 * (n - i)};
+        shapes.push_back(makeShape(c));
+    }
+    return shapes;
+}
+
+double forestSeconds(const vector<Shape>& shapes) {
+    double best = 1e300;
+    for (int run = 0; run < 3; ++run) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ContainmentForest forest(shapes);
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void forestOnChain() {
+    const int n = 4000;
+    vector<Shape> shapes = nestedChain(4 * n);
+    ContainmentForest forest(shapes);
+    size_t bad = 0;
+    for (int i = 0; i < 4 * n; ++i) bad += forest.parent(i) != i - 1 || forest.depth(i) != i;
+    check("ContainmentForest", "nested chain parents", bad, shapes.size());
+
+    double small = forestSeconds(nestedChain(n));
+    double large = forestSeconds(shapes);
+    check("ContainmentForest", "nested chain 4x time < 8x", large > 8 * small, 1);
+}
+
+// Площадь объединения квадратов по сетке из всех их границ
+double bruteUnionArea(const vector<Square>& squares) {
+    vector<double> xs, ys;
+    for (size_t i = 0; i < squares.size(); ++i) {
+        xs.push_back(squares[i].topLeft.x);
+        xs.push_back(squares[i].topLeft.x + squares[i].side);
+        ys.push_back(squares[i].topLeft.y);
+        ys.push_back(squares[i].topLeft.y - squares[i].side);
+    }
+    sort(xs.begin(), xs.end());
+    sort(ys.begin(), ys.end());
+    double area = 0;
+    for (size_t i = 0; i + 1 < xs.size(); ++i) {
+        for (size_t j = 0; j + 1 < ys.size(); ++j) {
+            Point mid = {(xs[i] + xs[i + 1]) / 2, (ys[j] + ys[j + 1]) / 2};
+            for (size_t k = 0; k < squares.size(); ++k) {
+                if (reference::isPointInSquare(mid, squares[k])) {
+                    area += (xs[i + 1] - xs[i]) * (ys[j + 1] - ys[j]);
+                    break;
+                }
+            }
+        }
+    }
+    return area;
+}
+
+void coverageAgainstBruteForce() {
+    mt19937 random(500);
+    uniform_real_distribution<double> coord(0, 100), size(1, 20);
+    size_t exactBad = 0, boundBad = 0;
+    const size_t rounds = 20;
+    for (size_t r = 0; r < rounds; ++r) {
+        vector<Square> squares;
+        vector<Shape> shapes;
+        for (size_t i = 0; i <= r * 5; ++i) {
+            Square s = {{coord(random), coord(random)}, size(random)};
+            squares.push_back(s);
+            shapes.push_back(makeShape(s));
+        }
+        double want = bruteUnionArea(squares);
+        double exact = unionAreaExact(squares, 4);
+        CoverageEstimate approx = unionAreaApprox(shapes, 0.1, 4);
+        exactBad += fabs(exact - want) > 1e-9 * want;
+        boundBad += fabs(approx.area - want) > approx.errorBound;
+    }
+    check("unionAreaExact", "brute force", exactBad, rounds);
+    check("unionAreaApprox", "error bound", boundBad, rounds);
+}
+
+Shape shifted(const Shape& shape, double dx, double dy) {
+    Shape moved = shape;
+    moved.circle.center.x += dx;
+    moved.circle.center.y += dy;
+    moved.square.topLeft.x += dx;
+    moved.square.topLeft.y += dy;
+    return moved;
+}
+
+// Случайные шаги из сдвигов, удалений и вставок между вызовами update().
+// Пары, собранные из событий, и partners() должны совпадать с полным
+// перебором по живым фигурам
+void dynamicAgainstBruteForce(size_t n, int steps) {
+    vector<Shape> scene = randomScene(n, 600);
+    mt19937 random(601);
+    uniform_real_distribution<double> jitter(-1.5, 1.5), coord(0, 200);
+    uniform_int_distribution<int> action(0, 99);
+
+    DynamicBVH tree(0.5);
+    vector<int> live;
+    vector<Shape> current;  // по идентификатору
+    for (size_t i = 0; i < scene.size(); ++i) {
+        int id = tree.insert(scene[i]);
+        if (static_cast<size_t>(id) >= current.size()) current.resize(id + 1);
+        current[id] = scene[i];
+        live.push_back(id);
+    }
+
+    set<pair<int, int> > pairs;
+    size_t eventBad = 0, pairBad = 0, partnerBad = 0, queryBad = 0;
+    PairEventCallback record = [&](const PairEvent& e) {
+        pair<int, int> key(min(e.first, e.second), max(e.first, e.second));
+        if (e.started) {
+            eventBad += !pairs.insert(key).second;
+        } else {
+            eventBad += pairs.erase(key) != 1;
+        }
+    };
+    tree.update(record);
+
+    for (int step = 0; step < steps; ++step) {
+        for (size_t k = 0; k < live.size(); ++k) {
+            int a = action(random);
+            if (a < 20) {
+                Shape moved = shifted(current[live[k]], jitter(random), jitter(random));
+                if (a == 0) moved = shifted(moved, coord(random) - 100, coord(random) - 100);
+                tree.move(live[k], moved);
+                current[live[k]] = moved;
+            } else if (a < 22) {
+                // Сдвиг перед удалением оставляет идентификатор в списке сдвинутых
+                if (a == 21) tree.move(live[k], shifted(current[live[k]], jitter(random), jitter(random)));
+                tree.remove(live[k]);
+                live[k] = live.back();
+                live.pop_back();
+                --k;
+            }
+        }
+        for (int i = 0; i < static_cast<int>(n / 50); ++i) {
+            Shape added = scene[random() % scene.size()];
+            added = shifted(added, jitter(random), jitter(random));
+            int id = tree.insert(added);
+            if (static_cast<size_t>(id) >= current.size()) current.resize(id + 1);
+            current[id] = added;
+            live.push_back(id);
+        }
+        tree.update(record);
+
+        sort(live.begin(), live.end());
+        set<pair<int, int> > want;
+        vector<vector<int> > partners(current.size());
+        for (size_t i = 0; i < live.size(); ++i) {
+            for (size_t j = i + 1; j < live.size(); ++j) {
+                if (!shapesIntersect(current[live[i]], current[live[j]])) continue;
+                want.insert(make_pair(live[i], live[j]));
+                partners[live[i]].push_back(live[j]);
+                partners[live[j]].push_back(live[i]);
+            }
+        }
+        pairBad += pairs != want;
+        for (size_t i = 0; i < live.size(); ++i) {
+            vector<int> got = tree.partners(live[i]);
+            sort(got.begin(), got.end());
+            sort(partners[live[i]].begin(), partners[live[i]].end());
+            partnerBad += got != partners[live[i]];
+        }
+
+        Shape probe = scene[random() % scene.size()];
+        vector<int> got = tree.query(probe), expected;
+        for (size_t i = 0; i < live.size(); ++i)
+            if (shapesIntersect(probe, current[live[i]])) expected.push_back(live[i]);
+        sort(got.begin(), got.end());
+        queryBad += got != expected;
+        partnerBad += tree.size() != live.size();
+    }
+    check("DynamicBVH", "events", eventBad, 1);
+    check("DynamicBVH", "pairs after update", pairBad, steps);
+    check("DynamicBVH", "partners", partnerBad, steps);
+    check("DynamicBVH::query", "shapes", queryBad, steps);
+}
+
+// Площадь объединения кругов и квадратов: интеграл длины сечения по x.
+// Границы квадратов и крайние точки кругов делят ось на куски, внутри
+// которых длина сечения непрерывна, каждый кусок считается по средним
+// точкам
+double bruteUnionArea(const vector<Shape>& shapes) {
+    vector<double> xs;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Box b = shapeBox(shapes[i]);
+        xs.push_back(b.minX);
+        xs.push_back(b.maxX);
+        if (shapes[i].kind == Shape::CIRCLE) xs.push_back(shapes[i].circle.center.x);
+    }
+    sort(xs.begin(), xs.end());
+
+    const int samples = 400;
+    double area = 0;
+    vector<pair<double, double> > spans;
+    for (size_t i = 0; i + 1 < xs.size(); ++i) {
+        double step = (xs[i + 1] - xs[i]) / samples;
+        for (int k = 0; k < samples; ++k) {
+            double x = xs[i] + (k + 0.5) * step;
+            spans.clear();
+            for (size_t j = 0; j < shapes.size(); ++j) {
+                if (shapes[j].kind == Shape::CIRCLE) {
+                    const Circle& c = shapes[j].circle;
+                    double dx = x - c.center.x;
+                    if (fabs(dx) >= c.radius) continue;
+                    double h = sqrt(c.radius * c.radius - dx * dx);
+                    spans.push_back(make_pair(c.center.y - h, c.center.y + h));
+                } else {
+                    const Square& s = shapes[j].square;
+                    if (x <= s.topLeft.x || x >= s.topLeft.x + s.side) continue;
+                    spans.push_back(make_pair(s.topLeft.y - s.side, s.topLeft.y));
+                }
+            }
+            sort(spans.begin(), spans.end());
+            double length = 0, top = -1e300;
+            for (size_t j = 0; j < spans.size(); ++j) {
+                double from = max(spans[j].first, top);
+                if (spans[j].second > from) length += spans[j].second - from;
+                top = max(top, spans[j].second);
+            }
+            area += length * step;
+        }
+    }
+    return area;
+}
+
+void coverageOfCirclesAgainstBruteForce() {
+    mt19937 random(510);
+    uniform_real_distribution<double> coord(0, 60), size(1, 12);
+    size_t bad = 0;
+    const size_t rounds = 10;
+    for (size_t r = 0; r < rounds; ++r) {
+        vector<Shape> shapes;
+        for (size_t i = 0; i <= r * 3; ++i) {
+            if (i % 3 == 2) {
+                Square s = {{coord(random), coord(random)}, size(random)};
+                shapes.push_back(makeShape(s));
+            } else {
+                Circle c = {{coord(random), coord(random)}, size(random)};
+                shapes.push_back(makeShape(c));
+            }
+        }
+        double want = bruteUnionArea(shapes);
+        CoverageEstimate approx = unionAreaApprox(shapes, 0.1, 4);
+        bad += fabs(approx.area - want) > approx.errorBound;
+    }
+    check("unionAreaApprox", "circles, error bound", bad, rounds);
+}
+
+typedef vector<pair<size_t, size_t> > IndexPairs;
+
+bool writeShapeFile(const char* filename, const ShapeSet& set) {
+    FILE* file = fopen(filename, "w");
+    if (!file) return false;
+    for (size_t i = 0; i < set.points.size(); ++i) fprintf(file, "P %.17g %.17g\n", set.points[i].x, set.points[i].y);
+    for (size_t i = 0; i < set.circles.size(); ++i) {
+        const Circle& c = set.circles[i];
+        fprintf(file, "C %.17g %.17g %.17g\n", c.center.x, c.center.y, c.radius);
+    }
+    for (size_t i = 0; i < set.squares.size(); ++i) {
+        const Square& s = set.squares[i];
+        fprintf(file, "S %.17g %.17g %.17g\n", s.topLeft.x, s.topLeft.y, s.side);
+    }
+    return fclose(file) == 0;
+}
+
+// Фигуры на сетке с шагом 0.5: много касаний и точек на границе
+ShapeSet gridShapes(size_t n, unsigned seed) {
+    mt19937 random(seed);
+    uniform_int_distribution<int> coord(0, 40), size(1, 8);
+    ShapeSet set;
+    for (size_t i = 0; i < n; ++i) {
+        set.points.push_back(Point{coord(random) * 0.5, coord(random) * 0.5});
+        set.circles.push_back(Circle{{coord(random) * 0.5, coord(random) * 0.5}, size(random) * 0.5});
+        set.squares.push_back(Square{{coord(random) * 0.5, coord(random) * 0.5}, size(random) * 0.5});
+    }
+    return set;
+}
+
+const char* const BATCH_SHAPES = "proptest_shapes.txt";
+const char* const BATCH_QUERIES = "proptest_queries.txt";
+const char* const BATCH_OUTPUT = "proptest_output.txt";
+
+bool runStructsBatch(const char* predicate, bool withQueries, IndexPairs& pairs) {
+    string command = string("./structs --batch ") + predicate + " " + BATCH_SHAPES;
+    if (withQueries) command += string(" ") + BATCH_QUERIES;
+    command += string(" -o ") + BATCH_OUTPUT + " 2>/dev/null";
+    pairs.clear();
+    if (system(command.c_str()) != 0) return false;
+    FILE* file = fopen(BATCH_OUTPUT, "r");
+    if (!file) return false;
+    size_t i, j;
+    while (fscanf(file, "%zu %zu", &i, &j) == 2) pairs.push_back(make_pair(i, j));
+    fclose(file);
+    sort(pairs.begin(), pairs.end());
+    return true;
+}
+
+// Как в runBatch: без файла запросов фигура не сравнивается с собой, у
+// симметричных предикатов берется только i < j
+template <typename Q, typename S, typename Pred>
+IndexPairs expectedPairs(const vector<Q>& queries, const vector<S>& shapes, bool self, bool symmetric, Pred pred) {
+    IndexPairs pairs;
+    for (size_t i = 0; i < queries.size(); ++i)
+        for (size_t j = 0; j < shapes.size(); ++j)
+            if (!(self && (symmetric ? j <= i : j == i)) && pred(queries[i], shapes[j])) pairs.push_back(make_pair(i, j));
+    return pairs;
+}
+
+template <typename Q, typename S, typename Pred>
+void checkBatchMode(const char* predicate, const vector<Q>& ownQueries, const vector<Q>& queries,
+                    const vector<S>& shapes, bool sameKind, bool symmetric, Pred pred) {
+    IndexPairs got;
+    bool ran = runStructsBatch(predicate, false, got);
+    check(predicate, "--batch self", !ran || got != expectedPairs(ownQueries, shapes, sameKind, symmetric, pred), 1);
+    ran = runStructsBatch(predicate, true, got);
+    check(predicate, "--batch queries", !ran || got != expectedPairs(queries, shapes, false, symmetric, pred), 1);
+}
+
+#define CHECK_BATCH(predicate, queryField, shapeField, sameKind, symmetric, Q, S, name)                   \
+    checkBatchMode(predicate, shapes.queryField, queries.queryField, shapes.shapeField, sameKind, symmetric, \
+                   [](const Q& a, const S& b) { return name(a, b); })
+
+void batchModeAgainstBruteForce(size_t n) {
+    ShapeSet shapes = gridShapes(n, 700), queries = gridShapes(n, 701);
+    if (!writeShapeFile(BATCH_SHAPES, shapes) || !writeShapeFile(BATCH_QUERIES, queries)) {
+        check("--batch", "input files", 1, 1);
+        return;
+    }
+    CHECK_BATCH("point-in-circle", points, circles, false, false, Point, Circle, isPointInCircle);
+    CHECK_BATCH("point-in-square", points, squares, false, false, Point, Square, isPointInSquare);
+    CHECK_BATCH("point-on-circle", points, circles, false, false, Point, Circle, isPointOnCircle);
+    CHECK_BATCH("point-on-square", points, squares, false, false, Point, Square, isPointOnSquare);
+    CHECK_BATCH("circles-intersect", circles, circles, true, true, Circle, Circle, circlesIntersect);
+    CHECK_BATCH("squares-intersect", squares, squares, true, true, Square, Square, squaresIntersect);
+    CHECK_BATCH("circle-square-intersect", circles, squares, false, false, Circle, Square, circleSquareIntersect);
+    CHECK_BATCH("circle-in-circle", circles, circles, true, false, Circle, Circle, isCircleInCircle);
+    CHECK_BATCH("square-in-square", squares, squares, true, false, Square, Square, isSquareInSquare);
+    CHECK_BATCH("square-in-circle", squares, circles, false, false, Square, Circle, isSquareInCircle);
+    CHECK_BATCH("circle-in-square", circles, squares, false, false, Circle, Square, isCircleInSquare);
+    remove(BATCH_SHAPES);
+    remove(BATCH_QUERIES);
+    remove(BATCH_OUTPUT);
+}
+
+}  // namespace
+
+// proptest [число случаев на проверку, по умолчанию 200000]
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    for (int k = HIT; k <= BOUNDARY; ++k) scalarAgainstReference(static_cast<Workload>(k), n);
+    for (int k = HIT; k <= BOUNDARY; ++k) {
+        templatesAgainstReference<AbsoluteTolerance, float>("float", static_cast<Workload>(k), n);
+        templatesAgainstReference<RelativeTolerance, double>("relative", static_cast<Workload>(k), n);
+    }
+    for (int k = HIT; k <= BOUNDARY; ++k) batchAgainstScalar(static_cast<Workload>(k), 1000);
+    fixedAgainstExact<int32_t>("fixed32", n);
+    fixedAgainstExact<int64_t>("fixed64", n);
+    fixedAtLimits(n);
+    indexesAgainstBruteForce(2000);
+    coverageAgainstBruteForce();
+    forestOnChain();
+    dynamicAgainstBruteForce(1000, 30);
+    coverageOfCirclesAgainstBruteForce();
+    batchModeAgainstBruteForce(300);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "shapeio.h"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char BINARY_MAGIC[4] = {'P', 'Z', '1', 'B'};
+const uint32_t BINARY_VERSION = 1;
+
+// Содержимое файла только для чтения: отображение в память, а где его
+// нет — чтение целиком
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0), mapped(false) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    bool open(const string& filename) {
+#ifdef _WIN32
+        ifstream file(filename, ios::binary);
+        if (!file) return false;
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                return false;
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(p);
+            mapped = true;
+        }
+        close(fd);
+        return true;
+#endif
+    }
+
+    const char* data;
+    size_t size;
+
+private:
+    bool mapped;
+#ifdef _WIN32
+    vector<char> buffer;
+#endif
+};
+
+bool parseText(const char* p, const char* end, ShapeSet& shapes, string& error) {
+    int line = 1;
+    double v[3];
+
+    while (p < end) {
+        // Пропуск пробелов, пустых строк и комментариев
+        if (*p == '\n') { ++line; ++p; continue; }
+        if (*p == ' ' || *p == '\t' || *p == '\r') { ++p; continue; }
+        if (*p == '#') {
+            while (p < end && *p != '\n') ++p;
+            continue;
+        }
+
+        char kind = *p++;
+        int count = (kind == 'P') ? 2 : (kind == 'C' || kind == 'S') ? 3 : 0;
+        if (count == 0) {
+            error = "line " + to_string(line) + ": unknown shape '" + string(1, kind) + "'";
+            return false;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+            from_chars_result r = from_chars(p, end, v[i]);
+            if (r.ec != errc()) {
+                error = "line " + to_string(line) + ": expected number";
+                return false;
+            }
+            p = r.ptr;
+        }
+
+        if (kind == 'P') {
+            shapes.points.push_back(Point{v[0], v[1]});
+        } else if (kind == 'C') {
+            shapes.circles.push_back(Circle{{v[0], v[1]}, v[2]});
+        } else {
+            shapes.squares.push_back(Square{{v[0], v[1]}, v[2]});
+        }
+    }
+    return true;
+}
+
+bool parseBinary(const char* p, size_t size, ShapeSet& shapes, string& error) {
+    const size_t headerSize = 4 + 4 + 3 * 8;
+    if (size < headerSize) {
+        error = "truncated header";
+        return false;
+    }
+
+    uint32_t version;
+    uint64_t counts[3];
+    memcpy(&version, p + 4, sizeof(version));
+    memcpy(counts, p + 8, sizeof(counts));
+    if (version != BINARY_VERSION) {
+        error = "unsupported version " + to_string(version);
+        return false;
+    }
+
+    uint64_t doubles = 2 * counts[0] + 3 * counts[1] + 3 * counts[2];
+    if (counts[0] > size || counts[1] > size || counts[2] > size ||
+        (size - headerSize) / sizeof(double) < doubles) {
+        error = "truncated data";
+        return false;
+    }
+
+    // Point, Circle и Square — плотные структуры из double, копируются блоком
+    const char* data = p + headerSize;
+    shapes.points.resize(counts[0]);
+    memcpy(shapes.points.data(), data, counts[0] * 2 * sizeof(double));
+    data += counts[0] * 2 * sizeof(double);
+    shapes.circles.resize(counts[1]);
+    memcpy(shapes.circles.data(), data, counts[1] * 3 * sizeof(double));
+    data += counts[1] * 3 * sizeof(double);
+    shapes.squares.resize(counts[2]);
+    memcpy(shapes.squares.data(), data, counts[2] * 3 * sizeof(double));
+    return true;
+}
+
+}
+
+static_assert(sizeof(Point) == 2 * sizeof(double), "Point must be two packed doubles");
+static_assert(sizeof(Circle) == 3 * sizeof(double), "Circle must be three packed doubles");
+static_assert(sizeof(Square) == 3 * sizeof(double), "Square must be three packed doubles");
+
+bool loadShapes(const string& filename, ShapeSet& shapes, string& error) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    bool ok;
+    if (file.size >= 4 && memcmp(file.data, BINARY_MAGIC, 4) == 0) {
+        ok = parseBinary(file.data, file.size, shapes, error);
+    } else {
+        ok = parseText(file.data, file.data + file.size, shapes, error);
+    }
+    if (!ok) error = filename + ": " + error;
+    return ok;
+}
+
+bool saveShapesBinary(const string& filename, const ShapeSet& shapes, string& error) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + filename;
+        return false;
+    }
+
+    uint64_t counts[3] = {shapes.points.size(), shapes.circles.size(), shapes.squares.size()};
+    bool ok = fwrite(BINARY_MAGIC, 1, 4, file) == 4 &&
+              fwrite(&BINARY_VERSION, sizeof(BINARY_VERSION), 1, file) == 1 &&
+              fwrite(counts, sizeof(counts), 1, file) == 1 &&
+              fwrite(shapes.points.data(), sizeof(Point), shapes.points.size(), file) == shapes.points.size() &&
+              fwrite(shapes.circles.data(), sizeof(Circle), shapes.circles.size(), file) == shapes.circles.size() &&
+              fwrite(shapes.squares.data(), sizeof(Square), shapes.squares.size(), file) == shapes.squares.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) error = "cannot write " + filename;
+    return ok;
+}
@@ -0,0 +1,28 @@
+#ifndef SHAPEIO_H
+#define SHAPEIO_H
+
+#include "structs.h"
+#include <string>
+#include <vector>
+
+// Набор фигур из файла
+struct ShapeSet {
+    std::vector<Point> points;
+    std::vector<Circle> circles;
+    std::vector<Square> squares;
+};
+
+// Текстовый формат: по фигуре на строку, # — комментарий
+//   P x y
+//   C center_x center_y radius
+//   S topLeft_x topLeft_y side
+//
+// Двоичный формат (little-endian):
+//   "PZ1B", uint32 версия (1), uint64 число точек, кругов, квадратов,
+//   затем подряд double: точки (x, y), круги (x, y, r), квадраты (x, y, side)
+//
+// Формат определяется по сигнатуре. Файл отображается в память целиком.
+bool loadShapes(const std::string& filename, ShapeSet& shapes, std::string& error);
+bool saveShapesBinary(const std::string& filename, const ShapeSet& shapes, std::string& error);
+
+#endif
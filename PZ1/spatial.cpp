@@ -0,0 +1,457 @@
+#include "spatial.h"
+#include "func.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <thread>
+
+using namespace std;
+
+Box circleBox(const Circle& c) {
+    Box b = {c.center.x - c.radius, c.center.y - c.radius, c.center.x + c.radius, c.center.y + c.radius};
+    return b;
+}
+
+Box squareBox(const Square& s) {
+    Box b = {s.topLeft.x, s.topLeft.y - s.side, s.topLeft.x + s.side, s.topLeft.y};
+    return b;
+}
+
+bool boxesOverlap(const Box& a, const Box& b) {
+    return a.minX <= b.maxX + EPS && b.minX <= a.maxX + EPS &&
+           a.minY <= b.maxY + EPS && b.minY <= a.maxY + EPS;
+}
+
+Shape makeShape(const Circle& c) {
+    Shape shape = {Shape::CIRCLE, c, Square()};
+    return shape;
+}
+
+Shape makeShape(const Square& s) {
+    Shape shape = {Shape::SQUARE, Circle(), s};
+    return shape;
+}
+
+Box shapeBox(const Shape& shape) {
+    return shape.kind == Shape::CIRCLE ? circleBox(shape.circle) : squareBox(shape.square);
+}
+
+bool shapesIntersect(const Shape& a, const Shape& b) {
+    if (a.kind == Shape::CIRCLE) {
+        return b.kind == Shape::CIRCLE ? circlesIntersect(a.circle, b.circle) : circleSquareIntersect(a.circle, b.square);
+    }
+    return b.kind == Shape::CIRCLE ? circleSquareIntersect(b.circle, a.square) : squaresIntersect(a.square, b.square);
+}
+
+double distanceToShape(const Point& p, const Shape& shape) {
+    if (shape.kind == Shape::CIRCLE) {
+        double dx = p.x - shape.circle.center.x;
+        double dy = p.y - shape.circle.center.y;
+        return max(0.0, sqrt(dx * dx + dy * dy) - shape.circle.radius);
+    }
+    const Square& s = shape.square;
+    double dx = max(s.topLeft.x, min(p.x, s.topLeft.x + s.side)) - p.x;
+    double dy = min(s.topLeft.y, max(p.y, s.topLeft.y - s.side)) - p.y;
+    return sqrt(dx * dx + dy * dy);
+}
+
+// Прямоугольник, расширенный на EPS / 2 с каждой стороны: два таких
+// прямоугольника пересекаются без допуска тогда и только тогда, когда
+// исходные пересекаются в смысле boxesOverlap
+static Box paddedBox(const Shape& shape) {
+    Box b = shapeBox(shape);
+    b.minX -= EPS / 2;
+    b.minY -= EPS / 2;
+    b.maxX += EPS / 2;
+    b.maxY += EPS / 2;
+    return b;
+}
+
+static bool touching(const Box& a, const Box& b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+static Box boxUnion(const Box& a, const Box& b) {
+    Box u = {min(a.minX, b.minX), min(a.minY, b.minY), max(a.maxX, b.maxX), max(a.maxY, b.maxY)};
+    return u;
+}
+
+// Равномерная сетка
+UniformGrid::UniformGrid(const vector<Shape>& shapes, double cellSize)
+    : shapes(shapes), cellSize(cellSize), originX(0), originY(0), columns(1), rows(1) {
+    size_t n = shapes.size();
+    boxes.resize(n);
+    if (n == 0) {
+        this->cellSize = 1;
+        cellStart.assign(2, 0);
+        return;
+    }
+
+    Box bounds = boxes[0] = paddedBox(shapes[0]);
+    double extentSum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        boxes[i] = paddedBox(shapes[i]);
+        bounds = boxUnion(bounds, boxes[i]);
+        extentSum += max(boxes[i].maxX - boxes[i].minX, boxes[i].maxY - boxes[i].minY);
+    }
+
+    double width = bounds.maxX - bounds.minX;
+    double height = bounds.maxY - bounds.minY;
+    if (this->cellSize <= 0) {
+        this->cellSize = extentSum / n;
+    }
+    // Не больше ~4 ячеек на фигуру, чтобы мелкие фигуры на большой сцене
+    // не раздували сетку
+    double maxCells = 4.0 * n + 16;
+    double cells = (width / this->cellSize + 1) * (height / this->cellSize + 1);
+    if (cells > maxCells) {
+        this->cellSize *= sqrt(cells / maxCells);
+    }
+
+    originX = bounds.minX;
+    originY = bounds.minY;
+    columns = static_cast<int>(width / this->cellSize) + 1;
+    rows = static_cast<int>(height / this->cellSize) + 1;
+
+    // Раскладка по ячейкам подсчетом: cellItems[cellStart[c] .. cellStart[c + 1])
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (int y = cellY(boxes[i].minY); y <= cellY(boxes[i].maxY); ++y) {
+            for (int x = cellX(boxes[i].minX); x <= cellX(boxes[i].maxX); ++x) {
+                ++cellStart[y * columns + x + 1];
+            }
+        }
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    cellItems.resize(cellStart.back());
+    vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        for (int y = cellY(boxes[i].minY); y <= cellY(boxes[i].maxY); ++y) {
+            for (int x = cellX(boxes[i].minX); x <= cellX(boxes[i].maxX); ++x) {
+                cellItems[fill[y * columns + x]++] = static_cast<int>(i);
+            }
+        }
+    }
+}
+
+int UniformGrid::cellX(double x) const {
+    int c = static_cast<int>(floor((x - originX) / cellSize));
+    return max(0, min(columns - 1, c));
+}
+
+int UniformGrid::cellY(double y) const {
+    int c = static_cast<int>(floor((y - originY) / cellSize));
+    return max(0, min(rows - 1, c));
+}
+
+// Пара, найденная в нескольких ячейках, засчитывается только в ячейке,
+// содержащей левый нижний угол пересечения прямоугольников
+vector<int> UniformGrid::query(const Shape& shape) const {
+    vector<int> result;
+    if (shapes.empty()) return result;
+
+    Box q = paddedBox(shape);
+    for (int y = cellY(q.minY); y <= cellY(q.maxY); ++y) {
+        for (int x = cellX(q.minX); x <= cellX(q.maxX); ++x) {
+            int cell = y * columns + x;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                int j = cellItems[k];
+                const Box& b = boxes[j];
+                if (!touching(q, b)) continue;
+                if (cellX(max(q.minX, b.minX)) != x || cellY(max(q.minY, b.minY)) != y) continue;
+                if (shapesIntersect(shape, shapes[j])) result.push_back(j);
+            }
+        }
+    }
+    return result;
+}
+
+vector<ShapePair> UniformGrid::allPairs() const {
+    vector<ShapePair> result;
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            int cell = y * columns + x;
+            for (int a = cellStart[cell]; a < cellStart[cell + 1]; ++a) {
+                for (int b = a + 1; b < cellStart[cell + 1]; ++b) {
+                    int i = cellItems[a];
+                    int j = cellItems[b];
+                    const Box& bi = boxes[i];
+                    const Box& bj = boxes[j];
+                    if (!touching(bi, bj)) continue;
+                    if (cellX(max(bi.minX, bj.minX)) != x || cellY(max(bi.minY, bj.minY)) != y) continue;
+                    if (shapesIntersect(shapes[i], shapes[j])) {
+                        ShapePair pair = {min(i, j), max(i, j)};
+                        result.push_back(pair);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// BVH
+BVH::BVH(const vector<Shape>& shapes) : shapes(shapes) {
+    size_t n = shapes.size();
+    boxes.resize(n);
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        boxes[i] = paddedBox(shapes[i]);
+        order[i] = static_cast<int>(i);
+    }
+    if (n > 0) {
+        nodes.reserve(2 * n / 4 + 1);
+        build(0, static_cast<int>(n));
+    }
+}
+
+int BVH::build(int start, int count) {
+    const int leafSize = 4;
+
+    Node node;
+    node.box = boxes[order[start]];
+    for (int k = start + 1; k < start + count; ++k) {
+        node.box = boxUnion(node.box, boxes[order[k]]);
+    }
+    node.left = node.right = -1;
+    node.start = start;
+    node.count = count;
+
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(node);
+    if (count <= leafSize) return index;
+
+    // Деление по медиане центров вдоль длинной оси
+    bool splitX = node.box.maxX - node.box.minX >= node.box.maxY - node.box.minY;
+    const vector<Box>& b = boxes;
+    vector<int>::iterator first = order.begin() + start;
+    nth_element(first, first + count / 2, first + count, [&](int i, int j) {
+        return splitX ? b[i].minX + b[i].maxX < b[j].minX + b[j].maxX
+                      : b[i].minY + b[i].maxY < b[j].minY + b[j].maxY;
+    });
+
+    int left = build(start, count / 2);
+    int right = build(start + count / 2, count - count / 2);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+template <typename Visitor>
+void BVH::visitOverlaps(const Box& box, Visitor visit) const {
+    if (nodes.empty()) return;
+
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!touching(node.box, box)) continue;
+        if (node.left < 0) {
+            for (int k = node.start; k < node.start + node.count; ++k) {
+                if (touching(boxes[order[k]], box)) visit(order[k]);
+            }
+        } else {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+}
+
+vector<int> BVH::query(const Shape& shape) const {
+    vector<int> result;
+    visitOverlaps(paddedBox(shape), [&](int j) {
+        if (shapesIntersect(shape, shapes[j])) result.push_back(j);
+    });
+    return result;
+}
+
+vector<int> BVH::overlapping(const Box& box) const {
+    vector<int> result;
+    Box padded = {box.minX - EPS / 2, box.minY - EPS / 2, box.maxX + EPS / 2, box.maxY + EPS / 2};
+    visitOverlaps(padded, [&](int j) { result.push_back(j); });
+    return result;
+}
+
+vector<ShapePair> BVH::allPairs() const {
+    vector<ShapePair> result;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        int first = static_cast<int>(i);
+        visitOverlaps(boxes[i], [&](int j) {
+            if (j > first && shapesIntersect(shapes[first], shapes[j])) {
+                ShapePair pair = {first, j};
+                result.push_back(pair);
+            }
+        });
+    }
+    return result;
+}
+
+// Квадрат расстояния от точки до прямоугольника
+static double boxDistance2(const Point& p, const Box& b) {
+    double dx = max(0.0, max(b.minX - p.x, p.x - b.maxX));
+    double dy = max(0.0, max(b.minY - p.y, p.y - b.maxY));
+    return dx * dx + dy * dy;
+}
+
+namespace {
+
+// Кандидат на место среди ближайших. Ключ — квадрат расстояния до фигуры.
+// Для круга отсечение "d - r > w" делается как d2 > (w + r)^2, так что
+// корень берется только у кругов, которые проходят в список.
+struct Candidate {
+    double key;  // квадрат расстояния до фигуры
+    int index;
+    bool operator<(const Candidate& other) const { return key < other.key; }
+};
+
+struct NodeEntry {
+    double bound2;
+    int node;
+    bool operator<(const NodeEntry& other) const { return bound2 > other.bound2; }
+};
+
+// Квадрат расстояния до фигуры, если она не дальше limit (limit < 0 — без
+// ограничения), иначе -1
+double shapeKey(const Point& p, const Shape& shape, double limit) {
+    if (shape.kind == Shape::CIRCLE) {
+        double dx = p.x - shape.circle.center.x;
+        double dy = p.y - shape.circle.center.y;
+        double d2 = dx * dx + dy * dy;
+        double r = shape.circle.radius;
+        if (d2 <= r * r && r >= 0) return 0;
+        if (limit >= 0 && d2 > (limit + r) * (limit + r)) return -1;
+        double d = sqrt(d2) - r;
+        return d > 0 ? d * d : 0;
+    }
+    const Square& s = shape.square;
+    double dx = max(s.topLeft.x, min(p.x, s.topLeft.x + s.side)) - p.x;
+    double dy = min(s.topLeft.y, max(p.y, s.topLeft.y - s.side)) - p.y;
+    double d2 = dx * dx + dy * dy;
+    if (limit >= 0 && d2 > limit * limit) return -1;
+    return d2;
+}
+
+int workerCount(int threads, size_t work) {
+    if (threads <= 0) threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    return static_cast<int>(min<size_t>(threads, max<size_t>(work / 256, 1)));
+}
+
+template <typename Work>
+void parallelFor(size_t n, int threads, Work work) {
+    int count = workerCount(threads, n);
+    vector<thread> pool;
+    for (int t = 1; t < count; ++t) {
+        pool.push_back(thread([&, t]() { work(n * t / count, n * (t + 1) / count); }));
+    }
+    work(0, n / count);
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+}
+
+}
+
+vector<Neighbor> BVH::nearest(const Point& p, size_t k) const {
+    vector<Neighbor> result;
+    if (k == 0 || nodes.empty()) return result;
+
+    priority_queue<Candidate> best;  // наверху самый дальний из найденных
+    priority_queue<NodeEntry> open;  // наверху самый близкий узел
+    double worst = -1;               // расстояние до самого дальнего, когда best полон
+
+    open.push(NodeEntry{boxDistance2(p, nodes[0].box), 0});
+    while (!open.empty()) {
+        NodeEntry entry = open.top();
+        open.pop();
+        if (best.size() == k && entry.bound2 >= best.top().key) break;
+
+        const Node& node = nodes[entry.node];
+        if (node.left >= 0) {
+            open.push(NodeEntry{boxDistance2(p, nodes[node.left].box), node.left});
+            open.push(NodeEntry{boxDistance2(p, nodes[node.right].box), node.right});
+            continue;
+        }
+
+        for (int i = node.start; i < node.start + node.count; ++i) {
+            int index = order[i];
+            double key = shapeKey(p, shapes[index], worst);
+            if (key < 0) continue;
+            if (best.size() < k) {
+                best.push(Candidate{key, index});
+            } else if (key < best.top().key) {
+                best.pop();
+                best.push(Candidate{key, index});
+            } else {
+                continue;
+            }
+            if (best.size() == k) worst = sqrt(best.top().key);
+        }
+    }
+
+    result.resize(best.size());
+    for (size_t i = result.size(); i > 0; --i) {
+        result[i - 1] = Neighbor{best.top().index, sqrt(best.top().key)};
+        best.pop();
+    }
+    return result;
+}
+
+vector<Neighbor> BVH::withinRadius(const Point& p, double radius) const {
+    vector<Neighbor> result;
+    if (nodes.empty() || radius < 0) return result;
+
+    double radius2 = radius * radius;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (boxDistance2(p, node.box) > radius2) continue;
+        if (node.left >= 0) {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+            continue;
+        }
+        for (int i = node.start; i < node.start + node.count; ++i) {
+            double key = shapeKey(p, shapes[order[i]], radius);
+            if (key >= 0 && key <= radius2) result.push_back(Neighbor{order[i], key});
+        }
+    }
+
+    for (size_t i = 0; i < result.size(); ++i) result[i].distance = sqrt(result[i].distance);
+    sort(result.begin(), result.end(), [](const Neighbor& a, const Neighbor& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+    });
+    return result;
+}
+
+vector<Neighbor> BVH::nearestBatch(const vector<Point>& points, size_t k, int threads) const {
+    size_t perQuery = min(k, shapes.size());
+    vector<Neighbor> result(points.size() * perQuery);
+    parallelFor(points.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            vector<Neighbor> found = nearest(points[i], k);
+            copy(found.begin(), found.end(), result.begin() + i * perQuery);
+        }
+    });
+    return result;
+}
+
+void BVH::withinRadiusBatch(const vector<Point>& points, double radius, vector<int>& offsets,
+                            vector<Neighbor>& result, int threads) const {
+    vector<vector<Neighbor> > found(points.size());
+    parallelFor(points.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) found[i] = withinRadius(points[i], radius);
+    });
+
+    offsets.assign(points.size() + 1, 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        offsets[i + 1] = offsets[i] + static_cast<int>(found[i].size());
+    }
+    result.clear();
+    result.reserve(offsets.back());
+    for (size_t i = 0; i < points.size(); ++i) {
+        result.insert(result.end(), found[i].begin(), found[i].end());
+    }
+}
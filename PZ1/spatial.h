@@ -0,0 +1,118 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "structs.h"
+#include <cstddef>
+#include <vector>
+
+// Ограничивающий прямоугольник, оси направлены как у Point (y вверх)
+struct Box {
+    double minX, minY, maxX, maxY;
+};
+
+Box circleBox(const Circle& c);
+Box squareBox(const Square& s);
+// Пересечение прямоугольников, касание с учетом EPS считается пересечением
+bool boxesOverlap(const Box& a, const Box& b);
+
+// Фигура сцены: круг или квадрат
+struct Shape {
+    enum Kind { CIRCLE, SQUARE };
+    Kind kind;
+    Circle circle;
+    Square square;
+};
+
+Shape makeShape(const Circle& c);
+Shape makeShape(const Square& s);
+Box shapeBox(const Shape& shape);
+// Точная проверка через circlesIntersect / squaresIntersect / circleSquareIntersect
+bool shapesIntersect(const Shape& a, const Shape& b);
+
+// Расстояние от точки до фигуры (0, если точка внутри): для круга —
+// расстояние до центра минус радиус, как в isPointOnCircle, для квадрата —
+// до ближайшей точки квадрата, как в circleSquareIntersect
+double distanceToShape(const Point& p, const Shape& shape);
+
+// Результат поиска ближайших
+struct Neighbor {
+    int index;
+    double distance;
+};
+
+// Пара индексов фигур, first < second
+struct ShapePair {
+    int first;
+    int second;
+};
+
+// Равномерная сетка. Фигура заносится во все ячейки, которые задевает ее
+// прямоугольник. При cellSize <= 0 размер ячейки выбирается по среднему
+// размеру фигур. Индекс хранит копию фигур.
+class UniformGrid {
+public:
+    explicit UniformGrid(const std::vector<Shape>& shapes, double cellSize = 0);
+
+    // Индексы всех фигур, пересекающихся с shape
+    std::vector<int> query(const Shape& shape) const;
+    // Все пересекающиеся пары фигур
+    std::vector<ShapePair> allPairs() const;
+
+    double getCellSize() const { return cellSize; }
+
+private:
+    std::vector<Shape> shapes;
+    std::vector<Box> boxes;
+    double cellSize;
+    double originX, originY;
+    int columns, rows;
+    std::vector<int> cellStart;
+    std::vector<int> cellItems;
+
+    int cellX(double x) const;
+    int cellY(double y) const;
+};
+
+// Иерархия ограничивающих объемов (BVH), строится делением по медиане
+// вдоль длинной оси. Подходит для сцен с сильно различающимися размерами.
+class BVH {
+public:
+    explicit BVH(const std::vector<Shape>& shapes);
+
+    std::vector<int> query(const Shape& shape) const;
+    std::vector<ShapePair> allPairs() const;
+    // Фигуры, чьи прямоугольники пересекаются с box (без точной проверки)
+    std::vector<int> overlapping(const Box& box) const;
+
+    // k ближайших к p фигур по возрастанию расстояния (обход лучшим первым
+    // с отсечением по границе прямоугольников)
+    std::vector<Neighbor> nearest(const Point& p, size_t k) const;
+    // Все фигуры не дальше radius от p, по возрастанию расстояния
+    std::vector<Neighbor> withinRadius(const Point& p, double radius) const;
+
+    // Пакетные версии, запросы делятся между потоками (threads <= 0 — по
+    // числу ядер). У nearestBatch на каждый запрос ровно min(k, число
+    // фигур) результатов подряд, у withinRadiusBatch — CSR, как в
+    // PointLocator::queryBatch.
+    std::vector<Neighbor> nearestBatch(const std::vector<Point>& points, size_t k, int threads = 0) const;
+    void withinRadiusBatch(const std::vector<Point>& points, double radius, std::vector<int>& offsets,
+                           std::vector<Neighbor>& result, int threads = 0) const;
+
+private:
+    struct Node {
+        Box box;
+        int left, right;   // дочерние узлы, -1 у листа
+        int start, count;  // диапазон в order у листа
+    };
+
+    std::vector<Shape> shapes;
+    std::vector<Box> boxes;
+    std::vector<int> order;
+    std::vector<Node> nodes;
+
+    int build(int start, int count);
+    template <typename Visitor>
+    void visitOverlaps(const Box& box, Visitor visit) const;
+};
+
+#endif
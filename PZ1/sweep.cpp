@@ -0,0 +1,140 @@
+#include "sweep.h"
+#include "func.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+// Прямоугольники в порядке возрастания minX (структура массивов)
+struct SortedBoxes {
+    vector<int> index;
+    vector<double> minX, maxX, minY, maxY;
+};
+
+SortedBoxes sortBoxes(const vector<Shape>& shapes) {
+    size_t n = shapes.size();
+    vector<Box> boxes(n);
+    SortedBoxes sorted;
+    sorted.index.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        boxes[i] = shapeBox(shapes[i]);
+        sorted.index[i] = static_cast<int>(i);
+    }
+    sort(sorted.index.begin(), sorted.index.end(), [&](int a, int b) {
+        return boxes[a].minX < boxes[b].minX;
+    });
+
+    sorted.minX.resize(n);
+    sorted.maxX.resize(n);
+    sorted.minY.resize(n);
+    sorted.maxY.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Box& b = boxes[sorted.index[k]];
+        sorted.minX[k] = b.minX;
+        sorted.maxX[k] = b.maxX;
+        sorted.minY[k] = b.minY;
+        sorted.maxY[k] = b.maxY;
+    }
+    return sorted;
+}
+
+// Проход для позиций [begin, end) отсортированного массива
+template <typename Emit>
+void sweepRange(const vector<Shape>& shapes, const SortedBoxes& s, size_t begin, size_t end, Emit emit) {
+    size_t n = s.index.size();
+    for (size_t a = begin; a < end; ++a) {
+        double limit = s.maxX[a] + EPS;
+        for (size_t b = a + 1; b < n && s.minX[b] <= limit; ++b) {
+            if (s.minY[b] > s.maxY[a] + EPS || s.minY[a] > s.maxY[b] + EPS) continue;
+            int i = s.index[a];
+            int j = s.index[b];
+            if (shapesIntersect(shapes[i], shapes[j])) {
+                ShapePair pair = {min(i, j), max(i, j)};
+                emit(pair);
+            }
+        }
+    }
+}
+
+int threadCount(int threads) {
+    if (threads > 0) return threads;
+    int hw = static_cast<int>(thread::hardware_concurrency());
+    return hw > 0 ? hw : 1;
+}
+
+// Блоки раздаются потокам динамически: плотные участки сцены не
+// задерживают весь проход
+template <typename Worker>
+void runBlocks(size_t n, int threads, Worker worker) {
+    const size_t blockSize = 1024;
+    size_t blocks = (n + blockSize - 1) / blockSize;
+    atomic<size_t> next(0);
+
+    auto loop = [&]() {
+        for (size_t block = next++; block < blocks; block = next++) {
+            worker(block, block * blockSize, min(n, (block + 1) * blockSize));
+        }
+    };
+
+    int count = min<size_t>(threadCount(threads), max<size_t>(blocks, 1));
+    vector<thread> pool;
+    for (int t = 1; t < count; ++t) {
+        pool.push_back(thread(loop));
+    }
+    loop();
+    for (size_t t = 0; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+}
+
+}
+
+vector<ShapePair> sweepAndPrune(const vector<Shape>& shapes, int threads) {
+    SortedBoxes sorted = sortBoxes(shapes);
+    size_t n = shapes.size();
+
+    // Буфер на каждый блок, склейка в порядке блоков: результат не
+    // зависит от числа потоков
+    vector<vector<ShapePair> > buffers((n + 1023) / 1024);
+    runBlocks(n, threads, [&](size_t block, size_t begin, size_t end) {
+        vector<ShapePair>& out = buffers[block];
+        sweepRange(shapes, sorted, begin, end, [&](const ShapePair& pair) { out.push_back(pair); });
+    });
+
+    size_t total = 0;
+    for (size_t b = 0; b < buffers.size(); ++b) total += buffers[b].size();
+
+    vector<ShapePair> result;
+    result.reserve(total);
+    for (size_t b = 0; b < buffers.size(); ++b) {
+        result.insert(result.end(), buffers[b].begin(), buffers[b].end());
+        vector<ShapePair>().swap(buffers[b]);
+    }
+    return result;
+}
+
+void sweepAndPrune(const vector<Shape>& shapes, const PairCallback& callback, int threads) {
+    const size_t flushSize = 4096;
+    SortedBoxes sorted = sortBoxes(shapes);
+    mutex callbackMutex;
+
+    runBlocks(shapes.size(), threads, [&](size_t, size_t begin, size_t end) {
+        vector<ShapePair> out;
+        out.reserve(flushSize);
+        auto flush = [&]() {
+            if (out.empty()) return;
+            lock_guard<mutex> lock(callbackMutex);
+            callback(out.data(), out.size());
+            out.clear();
+        };
+        sweepRange(shapes, sorted, begin, end, [&](const ShapePair& pair) {
+            out.push_back(pair);
+            if (out.size() == flushSize) flush();
+        });
+        flush();
+    });
+}
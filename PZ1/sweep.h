@@ -0,0 +1,20 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "spatial.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Получатель пар для потокового режима. Вызывается блоками по мере
+// заполнения буферов потоков, вызовы сериализованы мьютексом.
+typedef std::function<void(const ShapePair* pairs, size_t count)> PairCallback;
+
+// Все пересекающиеся пары методом "sweep and prune": прямоугольники
+// сортируются по minX, для каждого просматриваются следующие, пока они
+// перекрываются по x, отсекаются по y и проверяются точно через
+// shapesIntersect. threads <= 0 — по числу ядер.
+std::vector<ShapePair> sweepAndPrune(const std::vector<Shape>& shapes, int threads = 0);
+void sweepAndPrune(const std::vector<Shape>& shapes, const PairCallback& callback, int threads = 0);
+
+#endif
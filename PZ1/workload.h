@@ -0,0 +1,74 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "func.h"
+#include "structs.h"
+#include <random>
+#include <vector>
+
+// Случайные входные данные для bench и proptest.
+//   HIT      — второй объект маленький и лежит около центра первого
+//   MISS     — объекты далеко друг от друга
+//   BOUNDARY — координаты и размеры на сетке с шагом 0.5, половина из них
+//              сдвинута на величину порядка EPS: много касаний и ответов
+//              на самой границе допуска
+enum Workload { HIT, MISS, BOUNDARY };
+
+const char* const WORKLOAD_NAMES[] = {"hit", "miss", "boundary"};
+
+class WorkloadGenerator {
+public:
+    WorkloadGenerator(Workload kind, unsigned seed) : kind(kind), random(seed) {}
+
+    // Опорная фигура (второй аргумент предиката)
+    Point center() {
+        if (kind == BOUNDARY) return Point{grid(-4, 4), grid(-4, 4)};
+        return Point{uniform(-100, 100), uniform(-100, 100)};
+    }
+    double size() { return kind == BOUNDARY ? grid(0.5, 4) : uniform(5, 10); }
+
+    // Объект, проверяемый относительно опорного с центром c и размером s
+    Point near(const Point& c, double s) {
+        if (kind == HIT) return Point{c.x + uniform(-0.3, 0.3) * s, c.y + uniform(-0.3, 0.3) * s};
+        if (kind == MISS) return Point{c.x + uniform(30, 60), c.y - uniform(30, 60)};
+        return Point{c.x + grid(-4, 4), c.y + grid(-4, 4)};
+    }
+    double smallSize() { return kind == BOUNDARY ? grid(0.5, 4) : uniform(0.1, 1); }
+
+    Circle circle() {
+        Point c = center();
+        return Circle{c, size()};
+    }
+    Square square() {
+        double s = size();
+        Point c = center();
+        return Square{{c.x - s / 2, c.y + s / 2}, s};
+    }
+    Circle circleNear(const Circle& base) { return Circle{near(base.center, base.radius), smallSize()}; }
+    Circle circleNear(const Square& base) { return Circle{near(middle(base), base.side / 2), smallSize()}; }
+    Square squareNear(const Circle& base) { return squareAround(near(base.center, base.radius), smallSize()); }
+    Square squareNear(const Square& base) { return squareAround(near(middle(base), base.side / 2), smallSize()); }
+    Point pointNear(const Circle& base) { return near(base.center, base.radius); }
+    Point pointNear(const Square& base) { return near(middle(base), base.side / 2); }
+
+private:
+    Workload kind;
+    std::mt19937_64 random;
+
+    double uniform(double a, double b) { return std::uniform_real_distribution<double>(a, b)(random); }
+
+    double grid(double a, double b) {
+        int steps = static_cast<int>((b - a) * 2);
+        double v = a + 0.5 * std::uniform_int_distribution<int>(0, steps)(random);
+        if (random() & 1) v += EPS * 0.5 * std::uniform_int_distribution<int>(-3, 3)(random);
+        return v;
+    }
+
+    static Point middle(const Square& s) { return Point{s.topLeft.x + s.side / 2, s.topLeft.y - s.side / 2}; }
+    Square squareAround(const Point& c, double s) {
+        if (kind == BOUNDARY) return Square{c, s};
+        return Square{{c.x - s / 2, c.y + s / 2}, s};
+    }
+};
+
+#endif
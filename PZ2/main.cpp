@@ -1,36 +1,73 @@
 #include <iostream>
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <cstdint>
+#include <utility>
 
 class DynamicArray {
 private:
     int* data;
     size_t size;
+    size_t allocated; // Выделено элементов (>= size)
+
+    // Перевыделение буфера под newCapacity элементов. int тривиально
+    // копируется, поэтому realloc переносит данные сам и часто просто
+    // расширяет блок на месте
+    void reallocate(size_t newCapacity) {
+        if (newCapacity > SIZE_MAX / sizeof(int)) {
+            throw std::bad_alloc();
+        }
+        if (newCapacity == 0) {
+            std::free(data);
+            data = nullptr;
+        } else {
+            int* newData = static_cast<int*>(std::realloc(data, newCapacity * sizeof(int)));
+            if (!newData) {
+                throw std::bad_alloc();
+            }
+            data = newData;
+        }
+        allocated = newCapacity;
+    }
 
 public:
     // Конструктор, получающий размер массива
-    DynamicArray(size_t arraySize = 0) : size(arraySize) {
+    DynamicArray(size_t arraySize = 0) : size(arraySize), allocated(arraySize) {
         if (size > 0) {
-            data = new int[size](); // Инициализация нулями
+            data = static_cast<int*>(std::calloc(size, sizeof(int))); // Инициализация нулями
+            if (!data) {
+                throw std::bad_alloc();
+            }
         } else {
             data = nullptr;
         }
     }
 
     // Конструктор копирования (Задание 2)
-    DynamicArray(const DynamicArray& other) : size(other.size) {
+    DynamicArray(const DynamicArray& other) : size(other.size), allocated(other.size) {
         if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = other.data[i];
+            data = static_cast<int*>(std::malloc(size * sizeof(int)));
+            if (!data) {
+                throw std::bad_alloc();
             }
+            std::memcpy(data, other.data, size * sizeof(int));
         } else {
             data = nullptr;
         }
     }
 
+    // Конструктор перемещения: буфер забирается у other
+    DynamicArray(DynamicArray&& other) noexcept : data(other.data), size(other.size), allocated(other.allocated) {
+        other.data = nullptr;
+        other.size = 0;
+        other.allocated = 0;
+    }
+
     // Деструктор
     ~DynamicArray() {
-        delete[] data;
+        std::free(data);
     }
 
     // Функция вывода всех значений массива
@@ -73,26 +110,38 @@ public:
         return size;
     }
 
+    // Емкость: сколько элементов помещается без перевыделения
+    size_t capacity() const {
+        return allocated;
+    }
+
+    // Заранее выделить место под newCapacity элементов
+    void reserve(size_t newCapacity) {
+        if (newCapacity > allocated) {
+            reallocate(newCapacity);
+        }
+    }
+
+    // Вернуть лишнюю память, емкость становится равной размеру
+    void shrink_to_fit() {
+        if (allocated > size) {
+            reallocate(size);
+        }
+    }
+
     // Добавление значения в конец массива (Задание 3)
     void pushBack(int value) {
         if (value < -100 || value > 100) {
             throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
         }
 
-        // Создаем новый массив на 1 элемент больше
-        int* newData = new int[size + 1];
-        
-        // Копируем старые данные
-        for (size_t i = 0; i < size; ++i) {
-            newData[i] = data[i];
+        // Места не осталось: емкость растет вдвое, поэтому добавление
+        // в конец в среднем O(1)
+        if (size == allocated) {
+            reserve(allocated > 0 ? allocated * 2 : 4);
         }
-        
-        // Добавляем новый элемент
-        newData[size] = value;
-        
-        // Удаляем старый массив и обновляем указатель и размер
-        delete[] data;
-        data = newData;
+
+        data[size] = value;
         ++size;
     }
 
@@ -136,22 +185,19 @@ public:
         return result;
     }
 
-    // Оператор присваивания (для корректной работы с копированием)
-    DynamicArray& operator=(const DynamicArray& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
-                }
-            } else {
-                data = nullptr;
-            }
-        }
+    // Присваивание копированием и обменом: копия (или перемещение) делается
+    // в параметре, поэтому при исключении объект не меняется
+    DynamicArray& operator=(DynamicArray other) noexcept {
+        swap(other);
         return *this;
     }
+
+    // Обмен содержимым без выделения памяти
+    void swap(DynamicArray& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(allocated, other.allocated);
+    }
 };
 
 // Демонстрация работы класса
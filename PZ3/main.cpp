@@ -6,19 +6,38 @@
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <set>
+#include <map>
+#include <sstream>
+#include <cstdint>
 
 namespace fs = std::filesystem;
 
+struct NoiseEstimate {
+    double impulseDensity;
+    double gaussianSigma;
+};
+
 class PGMImage {
 private:
     int width, height, maxVal;
     std::vector<std::vector<int>> pixels;
+    
+    static bool readHeaderValue(std::istream& in, int& value) {
+        in >> std::ws;
+        while (in.peek() == '#') {
+            std::string comment;
+            std::getline(in, comment);
+            in >> std::ws;
+        }
+        return static_cast<bool>(in >> value);
+    }
 
 public:
     PGMImage() : width(0), height(0), maxVal(255) {}
     
     bool load(const std::string& filename) {
-        std::ifstream file(filename);
+        std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             std::cerr << "Cannot open file: " << filename << std::endl;
             return false;
@@ -26,21 +45,40 @@ public:
         
         std::string magicNumber;
         file >> magicNumber;
-        if (magicNumber != "P2") {
+        if (magicNumber != "P2" && magicNumber != "P5") {
             std::cerr << "Unsupported PGM format: " << magicNumber << std::endl;
             return false;
         }
         
-        file >> width >> height >> maxVal;
+        if (!readHeaderValue(file, width) || !readHeaderValue(file, height) || !readHeaderValue(file, maxVal) ||
+            width <= 0 || height <= 0 || maxVal <= 0 || maxVal > 65535) {
+            std::cerr << "Invalid PGM header: " << filename << std::endl;
+            return false;
+        }
         
-        pixels.resize(height, std::vector<int>(width));
+        pixels.assign(height, std::vector<int>(width));
         
-        for (int i = 0; i < height; ++i) {
-            for (int j = 0; j < width; ++j) {
-                if (!(file >> pixels[i][j])) {
+        if (magicNumber == "P5") {
+            file.get();
+            int bytesPerPixel = (maxVal < 256) ? 1 : 2;
+            std::vector<unsigned char> row(static_cast<size_t>(width) * bytesPerPixel);
+            for (int i = 0; i < height; ++i) {
+                if (!file.read(reinterpret_cast<char*>(row.data()), row.size())) {
                     return false;
                 }
-                pixels[i][j] = std::max(0, std::min(255, pixels[i][j]));
+                for (int j = 0; j < width; ++j) {
+                    int value = (bytesPerPixel == 1) ? row[j] : (row[2 * j] << 8) | row[2 * j + 1];
+                    pixels[i][j] = std::max(0, std::min(maxVal, value));
+                }
+            }
+        } else {
+            for (int i = 0; i < height; ++i) {
+                for (int j = 0; j < width; ++j) {
+                    if (!(file >> pixels[i][j])) {
+                        return false;
+                    }
+                    pixels[i][j] = std::max(0, std::min(maxVal, pixels[i][j]));
+                }
             }
         }
         
@@ -114,13 +152,23 @@ public:
         std::vector<std::vector<int>> filteredPixels = pixels;
         int offset = kernelSize / 2;
         
-        std::vector<std::vector<double>> kernel = {
-            {1, 2, 1},
-            {2, 4, 2},
-            {1, 2, 1}
-        };
+        std::vector<double> binomial(1, 1.0);
+        for (int k = 1; k < kernelSize; ++k) {
+            std::vector<double> next(k + 1, 1.0);
+            for (int m = 1; m < k; ++m) {
+                next[m] = binomial[m - 1] + binomial[m];
+            }
+            binomial = next;
+        }
         
-        double sum = 16.0;
+        std::vector<std::vector<double>> kernel(kernelSize, std::vector<double>(kernelSize));
+        double sum = 0.0;
+        for (int ki = 0; ki < kernelSize; ++ki) {
+            for (int kj = 0; kj < kernelSize; ++kj) {
+                kernel[ki][kj] = binomial[ki] * binomial[kj];
+                sum += kernel[ki][kj];
+            }
+        }
         
         for (int i = offset; i < height - offset; ++i) {
             for (int j = offset; j < width - offset; ++j) {
@@ -152,6 +200,93 @@ public:
         }
     }
     
+    // Impulse density from the histogram spikes at 0 and maxVal, Gaussian sigma
+    // from the mean absolute Laplacian response (Immerkaer) over pixels whose
+    // 3x3 neighbourhood contains no impulses. Single pass over the image.
+    NoiseEstimate estimateNoise() const {
+        NoiseEstimate estimate = {0.0, 0.0};
+        if (width < 3 || height < 3) return estimate;
+        
+        std::vector<long long> histogram(maxVal + 1, 0);
+        double laplacianSum = 0.0;
+        long long laplacianCount = 0;
+        
+        for (int i = 0; i < height; ++i) {
+            for (int j = 0; j < width; ++j) {
+                ++histogram[std::max(0, std::min(maxVal, pixels[i][j]))];
+                
+                if (i == 0 || j == 0 || i == height - 1 || j == width - 1) continue;
+                
+                bool hasImpulse = false;
+                for (int ki = -1; ki <= 1 && !hasImpulse; ++ki) {
+                    for (int kj = -1; kj <= 1; ++kj) {
+                        int v = pixels[i + ki][j + kj];
+                        if (v <= 0 || v >= maxVal) {
+                            hasImpulse = true;
+                            break;
+                        }
+                    }
+                }
+                if (hasImpulse) continue;
+                
+                int response = pixels[i - 1][j - 1] - 2 * pixels[i - 1][j] + pixels[i - 1][j + 1]
+                             - 2 * pixels[i][j - 1] + 4 * pixels[i][j] - 2 * pixels[i][j + 1]
+                             + pixels[i + 1][j - 1] - 2 * pixels[i + 1][j] + pixels[i + 1][j + 1];
+                laplacianSum += std::abs(response);
+                ++laplacianCount;
+            }
+        }
+        
+        double total = static_cast<double>(width) * height;
+        long long spikeLow = std::max(0LL, histogram[0] - histogram[1]);
+        long long spikeHigh = std::max(0LL, histogram[maxVal] - histogram[maxVal - 1]);
+        estimate.impulseDensity = (spikeLow + spikeHigh) / total;
+        
+        if (laplacianCount > 0) {
+            const double pi = 3.14159265358979323846;
+            estimate.gaussianSigma = std::sqrt(pi / 2.0) * laplacianSum / (6.0 * laplacianCount);
+        }
+        return estimate;
+    }
+    
+    // Filters the newest frame using all frames of the window (oldest first).
+    // spatialSize 1 gives a purely temporal filter, 3 a 3x3xN spatio-temporal one.
+    static PGMImage applyTemporalFilter(const std::vector<const PGMImage*>& frames, bool useMedian, int spatialSize = 1) {
+        const PGMImage& current = *frames.back();
+        PGMImage result = current;
+        if (spatialSize % 2 == 0) return result;
+        
+        int offset = spatialSize / 2;
+        std::vector<int> window;
+        window.reserve(frames.size() * spatialSize * spatialSize);
+        
+        for (int i = offset; i < current.height - offset; ++i) {
+            for (int j = offset; j < current.width - offset; ++j) {
+                window.clear();
+                for (const PGMImage* frame : frames) {
+                    for (int ki = -offset; ki <= offset; ++ki) {
+                        const std::vector<int>& row = frame->pixels[i + ki];
+                        for (int kj = -offset; kj <= offset; ++kj) {
+                            window.push_back(row[j + kj]);
+                        }
+                    }
+                }
+                
+                if (useMedian) {
+                    auto middle = window.begin() + window.size() / 2;
+                    std::nth_element(window.begin(), middle, window.end());
+                    result.pixels[i][j] = *middle;
+                } else {
+                    long long sum = 0;
+                    for (int v : window) sum += v;
+                    result.pixels[i][j] = static_cast<int>((sum + static_cast<long long>(window.size()) / 2) / static_cast<long long>(window.size()));
+                }
+            }
+        }
+        
+        return result;
+    }
+    
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     int getPixel(int x, int y) const { 
@@ -248,23 +383,301 @@ struct FilterResult {
     double ssim;
 };
 
-void processAllImages(const std::string& inputDir, const std::string& outputDir, const std::string& resultsFile) {
-    std::ofstream csv(resultsFile);
-    if (!csv.is_open()) {
-        std::cerr << "Cannot create results file: " << resultsFile << std::endl;
-        return;
+struct SweepConfig {
+    std::vector<double> noiseLevels = {0.01, 0.05, 0.1};
+    std::vector<int> filterSizes = {3, 5, 7};
+    std::vector<std::string> filters = {"Median", "Gaussian"};
+};
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool loadSweepConfig(const std::string& filename, SweepConfig& config) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << filename << ":" << lineNumber << ": expected key = value" << std::endl;
+            return false;
+        }
+
+        std::string key = trim(line.substr(0, eq));
+        std::vector<std::string> values = splitList(line.substr(eq + 1));
+
+        try {
+            if (key == "noise") {
+                config.noiseLevels.clear();
+                for (const auto& v : values) config.noiseLevels.push_back(std::stod(v));
+            } else if (key == "sizes") {
+                config.filterSizes.clear();
+                for (const auto& v : values) {
+                    int size = std::stoi(v);
+                    if (size < 1 || size % 2 == 0) {
+                        std::cerr << filename << ":" << lineNumber << ": filter size must be odd: " << v << std::endl;
+                        return false;
+                    }
+                    config.filterSizes.push_back(size);
+                }
+            } else if (key == "filters") {
+                for (const auto& v : values) {
+                    if (v != "Median" && v != "Gaussian") {
+                        std::cerr << filename << ":" << lineNumber << ": unknown filter: " << v << std::endl;
+                        return false;
+                    }
+                }
+                config.filters = values;
+            } else {
+                std::cerr << filename << ":" << lineNumber << ": unknown key: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << filename << ":" << lineNumber << ": invalid number in: " << line << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static std::string resultKey(const std::string& imageName, const std::string& filterName, const std::string& parameters) {
+    return imageName + "," + filterName + "," + parameters;
+}
+
+// Reads the rows already present in the results file and cuts off a trailing
+// partial row left behind by an interrupted run.
+std::set<std::string> loadCompletedResults(const std::string& resultsFile) {
+    std::set<std::string> completed;
+    std::ifstream file(resultsFile, std::ios::binary);
+    if (!file.is_open()) {
+        return completed;
+    }
+
+    std::string line;
+    std::uintmax_t validBytes = 0;
+    bool header = true;
+    while (std::getline(file, line)) {
+        if (file.eof()) break;
+        validBytes += line.size() + 1;
+        if (header) {
+            header = false;
+            continue;
+        }
+
+        // Image,Filter,size=N,noise=X,MSE,PSNR,SSIM
+        size_t pos = 0;
+        int commas = 0;
+        size_t keyEnd = std::string::npos;
+        while ((pos = line.find(',', pos)) != std::string::npos) {
+            if (++commas == 4) keyEnd = pos;
+            ++pos;
+        }
+        if (commas == 6) {
+            completed.insert(line.substr(0, keyEnd));
+        }
+    }
+    file.close();
+
+    if (fs::file_size(resultsFile) != validBytes) {
+        fs::resize_file(resultsFile, validBytes);
+    }
+    return completed;
+}
+
+struct FilterChoice {
+    std::string filterName;
+    int filterSize;
+};
+
+FilterChoice chooseFilter(const NoiseEstimate& estimate) {
+    if (estimate.impulseDensity > 0.002) {
+        if (estimate.impulseDensity < 0.1) return {"Median", 3};
+        if (estimate.impulseDensity < 0.25) return {"Median", 5};
+        return {"Median", 7};
     }
+    if (estimate.gaussianSigma > 2.0) {
+        if (estimate.gaussianSigma < 10.0) return {"Gaussian", 3};
+        if (estimate.gaussianSigma < 20.0) return {"Gaussian", 5};
+        return {"Gaussian", 7};
+    }
+    return {"None", 0};
+}
+
+void processAuto(const std::string& inputDir, const std::string& outputDir) {
+    fs::create_directories(outputDir);
     
-    csv << "Image,Filter,Parameters,MSE,PSNR,SSIM\n";
+    for (const auto& entry : fs::directory_iterator(inputDir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".pgm") continue;
+        
+        PGMImage image;
+        if (!image.load(entry.path().string())) {
+            continue;
+        }
+        
+        NoiseEstimate estimate = image.estimateNoise();
+        FilterChoice choice = chooseFilter(estimate);
+        
+        std::cout << "  impulse=" << estimate.impulseDensity << " sigma=" << estimate.gaussianSigma
+                  << " -> " << choice.filterName;
+        if (choice.filterSize > 0) std::cout << " " << choice.filterSize << "x" << choice.filterSize;
+        std::cout << std::endl;
+        
+        if (choice.filterName == "Median") {
+            image.applyMedianFilter(choice.filterSize);
+        } else if (choice.filterName == "Gaussian") {
+            image.applyGaussianFilter(choice.filterSize);
+        }
+        
+        image.save(outputDir + "/" + entry.path().stem().string() + "_auto.pgm");
+    }
+}
+
+// Groups numbered frames (ph1.pgm, ph2.pgm, ...) by prefix and filters each
+// sequence through a sliding window of the last windowSize frames.
+void processSequences(const std::string& inputDir, const std::string& outputDir,
+                      int windowSize, bool useMedian, int spatialSize) {
     fs::create_directories(outputDir);
     
-    std::vector<FilterResult> allResults;
+    std::map<std::string, std::vector<std::pair<int, fs::path>>> sequences;
+    for (const auto& entry : fs::directory_iterator(inputDir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".pgm") continue;
+        
+        std::string stem = entry.path().stem().string();
+        size_t digits = stem.find_last_not_of("0123456789");
+        if (digits == std::string::npos || digits + 1 == stem.size()) continue;
+        
+        std::string prefix = stem.substr(0, digits + 1);
+        int number;
+        try {
+            number = std::stoi(stem.substr(digits + 1));
+        } catch (const std::exception&) {
+            std::cerr << "Skipping frame with out-of-range number: " << entry.path().string() << std::endl;
+            continue;
+        }
+        sequences[prefix].push_back({number, entry.path()});
+    }
+    
+    if (sequences.empty()) {
+        std::cout << "No numbered PGM frames found in " << inputDir << std::endl;
+        return;
+    }
+    
+    std::string methodName = std::string(useMedian ? "median" : "mean") + (spatialSize > 1 ? "3d" : "");
     
+    for (auto& sequence : sequences) {
+        std::sort(sequence.second.begin(), sequence.second.end());
+        std::cout << "Sequence: " << sequence.first << "* (" << sequence.second.size() << " frames, window "
+                  << windowSize << ", " << methodName << ")" << std::endl;
+        
+        std::vector<PGMImage> ring(windowSize);
+        size_t next = 0;
+        size_t filled = 0;
+        
+        for (const auto& frameFile : sequence.second) {
+            PGMImage& slot = ring[next];
+            if (!slot.load(frameFile.second.string())) {
+                filled = 0;
+                continue;
+            }
+            
+            std::vector<const PGMImage*> frames;
+            size_t count = std::min(filled + 1, ring.size());
+            for (size_t k = count; k > 0; --k) {
+                const PGMImage& frame = ring[(next + ring.size() - (k - 1)) % ring.size()];
+                if (frame.getWidth() == slot.getWidth() && frame.getHeight() == slot.getHeight()) {
+                    frames.push_back(&frame);
+                }
+            }
+            
+            PGMImage filtered = PGMImage::applyTemporalFilter(frames, useMedian, spatialSize);
+            filtered.save(outputDir + "/" + frameFile.second.stem().string() + "_" + methodName +
+                          "_w" + std::to_string(windowSize) + ".pgm");
+            
+            next = (next + 1) % ring.size();
+            filled = std::min(filled + 1, ring.size());
+        }
+    }
+}
+
+void processAllImages(const std::string& inputDir, const std::string& outputDir,
+                      const std::string& resultsFile, const SweepConfig& config) {
+    std::set<std::string> completed = loadCompletedResults(resultsFile);
+    bool newFile = !fs::exists(resultsFile) || fs::file_size(resultsFile) == 0;
+
+    std::ofstream csv(resultsFile, std::ios::app);
+    if (!csv.is_open()) {
+        std::cerr << "Cannot create results file: " << resultsFile << std::endl;
+        return;
+    }
+
+    if (newFile) {
+        csv << "Image,Filter,Parameters,MSE,PSNR,SSIM\n";
+        csv.flush();
+    }
+    fs::create_directories(outputDir);
+
+    int imagesFound = 0;
+    int written = 0;
+    int skipped = 0;
+
+    auto writeResult = [&](const FilterResult& result) {
+        csv << result.imageName << "," << result.filterName << "," << result.parameters << ","
+            << result.mse << "," << result.psnr << "," << result.ssim << "\n";
+        csv.flush();
+        ++written;
+    };
+
     for (const auto& entry : fs::directory_iterator(inputDir)) {
         if (entry.is_regular_file() && entry.path().extension() == ".pgm") {
             std::string filename = entry.path().filename().string();
             std::string baseName = entry.path().stem().string();
-            
+            ++imagesFound;
+
+            auto isDone = [&](const std::string& filterName, const std::string& parameters) {
+                return completed.count(resultKey(filename, filterName, parameters)) > 0;
+            };
+            auto paramsFor = [](int filterSize, double noiseLevel) {
+                return "size=" + std::to_string(filterSize) + ",noise=" + std::to_string(noiseLevel);
+            };
+
+            bool imageDone = true;
+            for (double noiseLevel : config.noiseLevels) {
+                for (int filterSize : config.filterSizes) {
+                    for (const auto& filterName : config.filters) {
+                        if (!isDone(filterName, paramsFor(filterSize, noiseLevel))) imageDone = false;
+                    }
+                }
+            }
+            if (imageDone) {
+                std::cout << "Skipping (done): " << filename << std::endl;
+                skipped += static_cast<int>(config.noiseLevels.size() * config.filterSizes.size() * config.filters.size());
+                continue;
+            }
+
             std::cout << "Processing: " << filename << std::endl;
             
             PGMImage original;
@@ -272,71 +685,119 @@ void processAllImages(const std::string& inputDir, const std::string& outputDir,
                 continue;
             }
             
-            std::vector<int> filterSizes = {3, 5, 7};
-            std::vector<double> noiseLevels = {0.01, 0.05, 0.1};
-            
-            for (double noiseLevel : noiseLevels) {
+            for (double noiseLevel : config.noiseLevels) {
                 PGMImage noisy = original;
                 noisy.addNoise(noiseLevel);
                 
-                for (int filterSize : filterSizes) {
-                    PGMImage filteredMedian = noisy;
-                    filteredMedian.applyMedianFilter(filterSize);
-                    
-                    FilterResult resultMedian;
-                    resultMedian.imageName = filename;
-                    resultMedian.filterName = "Median";
-                    resultMedian.parameters = "size=" + std::to_string(filterSize) + ",noise=" + std::to_string(noiseLevel);
-                    resultMedian.mse = calculateMSE(original, filteredMedian);
-                    resultMedian.psnr = calculatePSNR(original, filteredMedian);
-                    resultMedian.ssim = calculateSSIM(original, filteredMedian);
-                    allResults.push_back(resultMedian);
-                    
-                    PGMImage filteredGaussian = noisy;
-                    filteredGaussian.applyGaussianFilter(filterSize);
-                    
-                    FilterResult resultGaussian;
-                    resultGaussian.imageName = filename;
-                    resultGaussian.filterName = "Gaussian";
-                    resultGaussian.parameters = "size=" + std::to_string(filterSize) + ",noise=" + std::to_string(noiseLevel);
-                    resultGaussian.mse = calculateMSE(original, filteredGaussian);
-                    resultGaussian.psnr = calculatePSNR(original, filteredGaussian);
-                    resultGaussian.ssim = calculateSSIM(original, filteredGaussian);
-                    allResults.push_back(resultGaussian);
-                    
-                    std::string outputFile = outputDir + "/" + baseName + "_n" + 
-                                           std::to_string(static_cast<int>(noiseLevel * 100)) + 
-                                           "_f" + std::to_string(filterSize) + ".pgm";
-                    filteredMedian.save(outputFile);
+                for (int filterSize : config.filterSizes) {
+                    std::string parameters = paramsFor(filterSize, noiseLevel);
+
+                    for (const auto& filterName : config.filters) {
+                        if (isDone(filterName, parameters)) {
+                            ++skipped;
+                            continue;
+                        }
+
+                        PGMImage filtered = noisy;
+                        if (filterName == "Median") {
+                            filtered.applyMedianFilter(filterSize);
+                        } else {
+                            filtered.applyGaussianFilter(filterSize);
+                        }
+
+                        FilterResult result;
+                        result.imageName = filename;
+                        result.filterName = filterName;
+                        result.parameters = parameters;
+                        result.mse = calculateMSE(original, filtered);
+                        result.psnr = calculatePSNR(original, filtered);
+                        result.ssim = calculateSSIM(original, filtered);
+                        writeResult(result);
+
+                        if (filterName == "Median") {
+                            std::string outputFile = outputDir + "/" + baseName + "_n" + 
+                                                   std::to_string(static_cast<int>(noiseLevel * 100)) + 
+                                                   "_f" + std::to_string(filterSize) + ".pgm";
+                            filtered.save(outputFile);
+                        }
+                    }
                 }
             }
         }
     }
     
-    if (allResults.empty()) {
+    if (imagesFound == 0) {
         std::cout << "No PGM files found. Creating test image." << std::endl;
         PGMImage testImage;
         testImage.createTestImage(100, 100);
         testImage.save(inputDir + "/test.pgm");
         
-        processAllImages(inputDir, outputDir, resultsFile);
+        csv.close();
+        processAllImages(inputDir, outputDir, resultsFile, config);
         return;
     }
     
-    for (const auto& result : allResults) {
-        csv << result.imageName << "," << result.filterName << "," << result.parameters << ","
-            << result.mse << "," << result.psnr << "," << result.ssim << "\n";
-    }
-    
     csv.close();
     std::cout << "Results saved to: " << resultsFile << std::endl;
-    std::cout << "Total tests: " << allResults.size() << std::endl;
+    std::cout << "Total tests: " << written << " (skipped " << skipped << " already done)" << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::string inputDir = "images";
     std::string outputDir = "processed";
     std::string resultsFile = "denoising_results.csv";
+    std::string mode = "sweep";
+    std::string configFile = "sweep.cfg";
+    if (argc > 1) {
+        std::string arg = argv[1];
+        if (arg == "sequence") {
+            int windowSize = 3;
+            bool validWindow = true;
+            if (argc > 2) {
+                try {
+                    size_t used = 0;
+                    windowSize = std::stoi(argv[2], &used);
+                    validWindow = argv[2][used] == '\0';
+                } catch (const std::exception&) {
+                    validWindow = false;
+                }
+            }
+            std::string method = (argc > 3) ? argv[3] : "median";
+            if (!validWindow || windowSize < 1 || (method != "median" && method != "mean" &&
+                                   method != "median3d" && method != "mean3d")) {
+                std::cerr << "Usage: " << argv[0] << " sequence [window] [median|mean|median3d|mean3d]" << std::endl;
+                return 1;
+            }
+            
+            fs::create_directories(inputDir);
+            std::cout << "Image Denoising (sequence)" << std::endl;
+            processSequences(inputDir, outputDir, windowSize, method.compare(0, 6, "median") == 0,
+                             method.size() > 2 && method.substr(method.size() - 2) == "3d" ? 3 : 1);
+            return 0;
+        }
+        if (arg == "auto" || arg == "sweep") {
+            mode = arg;
+            if (argc > 2) configFile = argv[2];
+        } else {
+            configFile = arg;
+        }
+    }
+    
+    if (mode == "auto") {
+        fs::create_directories(inputDir);
+        std::cout << "Image Denoising (auto)" << std::endl;
+        processAuto(inputDir, outputDir);
+        return 0;
+    }
+
+    SweepConfig config;
+    if (fs::exists(configFile)) {
+        if (!loadSweepConfig(configFile, config)) {
+            std::cerr << "Invalid sweep config: " << configFile << std::endl;
+            return 1;
+        }
+        std::cout << "Config: " << configFile << std::endl;
+    }
     
     fs::create_directories(inputDir);
     
@@ -344,7 +805,7 @@ int main() {
     std::cout << "Input: " << inputDir << std::endl;
     std::cout << "Output: " << outputDir << std::endl;
     
-    processAllImages(inputDir, outputDir, resultsFile);
+    processAllImages(inputDir, outputDir, resultsFile, config);
     
     std::cout << "Analysis completed" << std::endl;
     return 0;
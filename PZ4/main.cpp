@@ -1,35 +1,181 @@
 #include <iostream>
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <cstdint>
+#include <utility>
 #include <algorithm>
 #include <vector>
+#include <chrono>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Значения лежат в [-100, 100] и хранятся в int8_t; ядра ниже
+// обрабатывают по 32 элемента за инструкцию AVX2
+
+static void addClamped(const int8_t* a, const int8_t* b, int8_t* out, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i low = _mm256_set1_epi8(-100);
+    const __m256i high = _mm256_set1_epi8(100);
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i sum = _mm256_min_epi8(_mm256_max_epi8(_mm256_adds_epi8(va, vb), low), high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sum);
+    }
+#endif
+    for (; i < n; ++i) {
+        int sum = a[i] + b[i];
+        out[i] = static_cast<int8_t>(sum < -100 ? -100 : (sum > 100 ? 100 : sum));
+    }
+}
+
+static void subtractClamped(const int8_t* a, const int8_t* b, int8_t* out, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i low = _mm256_set1_epi8(-100);
+    const __m256i high = _mm256_set1_epi8(100);
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i diff = _mm256_min_epi8(_mm256_max_epi8(_mm256_subs_epi8(va, vb), low), high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), diff);
+    }
+#endif
+    for (; i < n; ++i) {
+        int diff = a[i] - b[i];
+        out[i] = static_cast<int8_t>(diff < -100 ? -100 : (diff > 100 ? 100 : diff));
+    }
+}
+
+static long long sumValues(const int8_t* values, size_t n) {
+    long long sum = 0;
+    size_t i = 0;
+#ifdef __AVX2__
+    // Сдвиг на 128 делает байты беззнаковыми, sad_epu8 складывает по 8
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    __m256i total = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), bias);
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+    }
+    long long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3] - 128LL * static_cast<long long>(i);
+#endif
+    for (; i < n; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static void minMaxValues(const int8_t* values, size_t n, int& minVal, int& maxVal) {
+    int8_t lo = values[0];
+    int8_t hi = values[0];
+    size_t i = 0;
+#ifdef __AVX2__
+    if (n >= 32) {
+        __m256i vmin = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        __m256i vmax = vmin;
+        for (i = 32; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            vmin = _mm256_min_epi8(vmin, v);
+            vmax = _mm256_max_epi8(vmax, v);
+        }
+        int8_t lanesMin[32], lanesMax[32];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesMin), vmin);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesMax), vmax);
+        for (int k = 0; k < 32; ++k) {
+            lo = std::min(lo, lanesMin[k]);
+            hi = std::max(hi, lanesMax[k]);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    minVal = lo;
+    maxVal = hi;
+}
+
+template <typename Left, typename Right, bool Subtract>
+class ArraySum;
 
 class DynamicArray {
 private:
-    int* data;
+    int8_t* data;
     size_t size;
+    size_t allocated;
+    size_t version;
+    static size_t allocations;
+
+    void reallocate(size_t newCapacity) {
+        if (newCapacity > SIZE_MAX / sizeof(int8_t)) {
+            throw std::bad_alloc();
+        }
+        if (newCapacity == 0) {
+            std::free(data);
+            data = nullptr;
+        } else {
+            int8_t* newData = static_cast<int8_t*>(std::realloc(data, newCapacity));
+            if (!newData) {
+                throw std::bad_alloc();
+            }
+            ++allocations;
+            data = newData;
+        }
+        allocated = newCapacity;
+    }
 
 public:
-    DynamicArray(size_t arraySize = 0) : size(arraySize) {
+    DynamicArray(size_t arraySize = 0) : size(arraySize), allocated(arraySize), version(0) {
         if (size > 0) {
-            data = new int[size]();
+            data = static_cast<int8_t*>(std::calloc(size, 1));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            ++allocations;
         } else {
             data = nullptr;
         }
     }
 
-    DynamicArray(const DynamicArray& other) : size(other.size) {
+    DynamicArray(const DynamicArray& other) : size(other.size), allocated(other.size), version(other.version) {
         if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = other.data[i];
+            data = static_cast<int8_t*>(std::malloc(size));
+            if (!data) {
+                throw std::bad_alloc();
             }
+            ++allocations;
+            std::memcpy(data, other.data, size);
         } else {
             data = nullptr;
         }
     }
 
+    template <typename Left, typename Right, bool Subtract>
+    DynamicArray(const ArraySum<Left, Right, Subtract>& expr) : data(nullptr), size(0), allocated(0), version(0) {
+        assign(expr);
+    }
+
+    DynamicArray(DynamicArray&& other) noexcept
+        : data(other.data), size(other.size), allocated(other.allocated), version(other.version) {
+        other.data = nullptr;
+        other.size = 0;
+        other.allocated = 0;
+        ++other.version;
+    }
+
     ~DynamicArray() {
-        delete[] data;
+        std::free(data);
     }
 
     void print() const {
@@ -38,7 +184,7 @@ public:
             std::cout << "пустой";
         } else {
             for (size_t i = 0; i < size; ++i) {
-                std::cout << data[i];
+                std::cout << static_cast<int>(data[i]);
                 if (i < size - 1) {
                     std::cout << ", ";
                 }
@@ -54,7 +200,8 @@ public:
         if (value < -100 || value > 100) {
             throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
         }
-        data[index] = value;
+        data[index] = static_cast<int8_t>(value);
+        ++version;
     }
 
     int getValue(size_t index) const {
@@ -68,87 +215,512 @@ public:
         return size;
     }
 
+    size_t capacity() const {
+        return allocated;
+    }
+
+    static size_t getAllocations() {
+        return allocations;
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > allocated) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (allocated > size) {
+            reallocate(size);
+        }
+    }
+
     void pushBack(int value) {
         if (value < -100 || value > 100) {
             throw std::invalid_argument("Значение должно быть в диапазоне от -100 до 100");
         }
 
-        int* newData = new int[size + 1];
-        
-        for (size_t i = 0; i < size; ++i) {
-            newData[i] = data[i];
+        if (size == allocated) {
+            reserve(allocated > 0 ? allocated * 2 : 4);
         }
-        
-        newData[size] = value;
-        
-        delete[] data;
-        data = newData;
+
+        data[size] = static_cast<int8_t>(value);
         ++size;
+        ++version;
     }
 
     DynamicArray add(const DynamicArray& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        DynamicArray result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int sum = val1 + val2;
-            
-            if (sum < -100) sum = -100;
-            if (sum > 100) sum = 100;
-            
-            result.data[i] = sum;
-        }
-
+        DynamicArray result;
+        add_into(result, *this, other);
         return result;
     }
 
     DynamicArray subtract(const DynamicArray& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        DynamicArray result(maxSize);
+        DynamicArray result;
+        subtract_into(result, *this, other);
+        return result;
+    }
 
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int diff = val1 - val2;
-            
-            if (diff < -100) diff = -100;
-            if (diff > 100) diff = 100;
-            
-            result.data[i] = diff;
-        }
+    template <typename Left, typename Right, bool Subtract>
+    DynamicArray& operator=(const ArraySum<Left, Right, Subtract>& expr) {
+        assign(expr);
+        return *this;
+    }
 
-        return result;
+    DynamicArray& operator+=(const DynamicArray& other) {
+        add_into(*this, *this, other);
+        return *this;
     }
 
-    DynamicArray& operator=(const DynamicArray& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
-                }
-            } else {
-                data = nullptr;
-            }
+    DynamicArray& operator-=(const DynamicArray& other) {
+        subtract_into(*this, *this, other);
+        return *this;
+    }
+
+    friend void add_into(DynamicArray& out, const DynamicArray& a, const DynamicArray& b) {
+        size_t common = (a.size < b.size) ? a.size : b.size;
+        size_t maxSize = (a.size > b.size) ? a.size : b.size;
+        out.reserve(maxSize);
+
+        addClamped(a.data, b.data, out.data, common);
+        const DynamicArray& longer = (a.size > b.size) ? a : b;
+        if (maxSize > common) {
+            std::memmove(out.data + common, longer.data + common, maxSize - common);
+        }
+        out.size = maxSize;
+        ++out.version;
+    }
+
+    friend void subtract_into(DynamicArray& out, const DynamicArray& a, const DynamicArray& b) {
+        size_t common = (a.size < b.size) ? a.size : b.size;
+        size_t maxSize = (a.size > b.size) ? a.size : b.size;
+        out.reserve(maxSize);
+
+        subtractClamped(a.data, b.data, out.data, common);
+        if (a.size > common) {
+            std::memmove(out.data + common, a.data + common, a.size - common);
+        }
+        for (size_t i = common; i < b.size; ++i) {
+            out.data[i] = static_cast<int8_t>(-b.data[i]);
         }
+        out.size = maxSize;
+        ++out.version;
+    }
+
+    DynamicArray& operator=(DynamicArray other) noexcept {
+        swap(other);
         return *this;
     }
 
+    void swap(DynamicArray& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(allocated, other.allocated);
+        version = other.version = std::max(version, other.version) + 1;
+    }
+
 protected:
-    int* getData() const {
+    const int8_t* getData() const {
         return data;
     }
+
+    // Растет при каждом изменении содержимого, в том числе при обмене и
+    // присваивании: наследник по нему узнает, что его кэш устарел
+    size_t getVersion() const {
+        return version;
+    }
+
+private:
+    friend class ArrayLeaf;
+
+    // Один проход по всему выражению; размеры листьев читаются до записи,
+    // поэтому out может входить в выражение (a = a + b)
+    template <typename Expr>
+    void assign(const Expr& expr) {
+        size_t n = expr.size();
+        reserve(n);
+        size_t i = 0;
+#ifdef __AVX2__
+        size_t dense = expr.dense();
+        for (; i + 32 <= dense; i += 32) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), expr.load(i));
+        }
+#endif
+        for (; i < n; ++i) {
+            data[i] = static_cast<int8_t>(expr.value(i));
+        }
+        size = n;
+        ++version;
+    }
 };
 
+size_t DynamicArray::allocations = 0;
+
+// Шаблоны выражений: a + b - c + d строит дерево из ссылок на массивы и
+// считается одним циклом при присваивании. Каждый узел обрезает результат
+// до [-100, 100], как add/subtract, так что ответ совпадает с цепочкой
+// a.add(b).subtract(c).add(d). Недостающие элементы короткого массива
+// считаются нулями.
+class ArrayLeaf {
+public:
+    explicit ArrayLeaf(const DynamicArray& array) : array(&array) {}
+
+    size_t size() const {
+        return array->size;
+    }
+
+    // Префикс, в котором все листья можно читать векторно
+    size_t dense() const {
+        return array->size;
+    }
+
+    int value(size_t i) const {
+        return i < array->size ? array->data[i] : 0;
+    }
+
+#ifdef __AVX2__
+    __m256i load(size_t i) const {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(array->data + i));
+    }
+#endif
+
+private:
+    const DynamicArray* array;
+};
+
+template <typename Left, typename Right, bool Subtract>
+class ArraySum {
+public:
+    ArraySum(const Left& left, const Right& right) : left(left), right(right) {}
+
+    size_t size() const {
+        return std::max(left.size(), right.size());
+    }
+
+    size_t dense() const {
+        return std::min(left.dense(), right.dense());
+    }
+
+    int value(size_t i) const {
+        int result = Subtract ? left.value(i) - right.value(i) : left.value(i) + right.value(i);
+        return result < -100 ? -100 : (result > 100 ? 100 : result);
+    }
+
+#ifdef __AVX2__
+    __m256i load(size_t i) const {
+        __m256i a = left.load(i);
+        __m256i b = right.load(i);
+        __m256i result = Subtract ? _mm256_subs_epi8(a, b) : _mm256_adds_epi8(a, b);
+        return _mm256_min_epi8(_mm256_max_epi8(result, _mm256_set1_epi8(-100)), _mm256_set1_epi8(100));
+    }
+#endif
+
+private:
+    Left left;
+    Right right;
+};
+
+// Операнд выражения: массив (в том числе наследник) становится листом,
+// выражение берется как есть
+template <typename T, bool IsArray = std::is_base_of<DynamicArray, T>::value>
+struct ArrayOperand {};
+
+template <typename T>
+struct ArrayOperand<T, true> {
+    typedef ArrayLeaf Type;
+    static Type wrap(const T& array) {
+        return ArrayLeaf(array);
+    }
+};
+
+template <typename Left, typename Right, bool Subtract>
+struct ArrayOperand<ArraySum<Left, Right, Subtract>, false> {
+    typedef ArraySum<Left, Right, Subtract> Type;
+    static const Type& wrap(const Type& expr) {
+        return expr;
+    }
+};
+
+template <typename A, typename B>
+ArraySum<typename ArrayOperand<A>::Type, typename ArrayOperand<B>::Type, false> operator+(const A& a, const B& b) {
+    return ArraySum<typename ArrayOperand<A>::Type, typename ArrayOperand<B>::Type, false>(
+        ArrayOperand<A>::wrap(a), ArrayOperand<B>::wrap(b));
+}
+
+template <typename A, typename B>
+ArraySum<typename ArrayOperand<A>::Type, typename ArrayOperand<B>::Type, true> operator-(const A& a, const B& b) {
+    return ArraySum<typename ArrayOperand<A>::Type, typename ArrayOperand<B>::Type, true>(
+        ArrayOperand<A>::wrap(a), ArrayOperand<B>::wrap(b));
+}
+
+// Гистограмма по 201 возможному значению: медиана, квантили и мода за
+// один проход без сортировки и без выделения памяти
+class ValueHistogram {
+public:
+    static const int MIN_VALUE = -100;
+    static const int BUCKETS = 201;
+
+    ValueHistogram() : total(0) {
+        std::fill(counts, counts + BUCKETS, 0);
+    }
+
+    void add(const int8_t* values, size_t n) {
+        // Четыре таблицы, чтобы соседние одинаковые значения не ждали
+        // друг друга на инкременте одного счетчика
+        uint32_t partial[4][BUCKETS];
+        size_t i = 0;
+        while (i < n) {
+            std::memset(partial, 0, sizeof(partial));
+            size_t end = std::min(n, i + (size_t(1) << 30));
+            for (; i + 4 <= end; i += 4) {
+                ++partial[0][values[i] - MIN_VALUE];
+                ++partial[1][values[i + 1] - MIN_VALUE];
+                ++partial[2][values[i + 2] - MIN_VALUE];
+                ++partial[3][values[i + 3] - MIN_VALUE];
+            }
+            for (; i < end; ++i) {
+                ++partial[0][values[i] - MIN_VALUE];
+            }
+            for (int b = 0; b < BUCKETS; ++b) {
+                counts[b] += static_cast<uint64_t>(partial[0][b]) + partial[1][b] + partial[2][b] + partial[3][b];
+            }
+        }
+        total += n;
+    }
+
+    void add(int value) {
+        ++counts[value - MIN_VALUE];
+        ++total;
+    }
+
+    void remove(int value) {
+        --counts[value - MIN_VALUE];
+        --total;
+    }
+
+    void merge(const ValueHistogram& other) {
+        for (int b = 0; b < BUCKETS; ++b) {
+            counts[b] += other.counts[b];
+        }
+        total += other.total;
+    }
+
+    uint64_t count(int value) const {
+        if (value < MIN_VALUE || value >= MIN_VALUE + BUCKETS) {
+            return 0;
+        }
+        return counts[value - MIN_VALUE];
+    }
+
+    uint64_t size() const {
+        return total;
+    }
+
+    // Значение на месте rank (с нуля) в отсортированном массиве
+    int valueAt(uint64_t rank) const {
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += counts[b];
+            if (rank < seen) {
+                return b + MIN_VALUE;
+            }
+        }
+        throw std::out_of_range("Ранг выходит за размер гистограммы");
+    }
+
+    // Квантиль с линейной интерполяцией между соседними по рангу
+    // значениями; quantile(0.5) — обычная медиана
+    double quantile(double q) const {
+        if (total == 0) {
+            throw std::runtime_error("Массив пустой");
+        }
+        if (!(q >= 0.0 && q <= 1.0)) {
+            throw std::invalid_argument("Квантиль должен быть в диапазоне от 0 до 1");
+        }
+        double position = q * static_cast<double>(total - 1);
+        uint64_t lower = static_cast<uint64_t>(position);
+        double fraction = position - static_cast<double>(lower);
+        int low = valueAt(lower);
+        if (fraction == 0.0) {
+            return low;
+        }
+        int high = valueAt(lower + 1);
+        return low + fraction * (high - low);
+    }
+
+    double median() const {
+        if (total == 0) {
+            throw std::runtime_error("Массив пустой");
+        }
+        int low = valueAt((total - 1) / 2);
+        int high = valueAt(total / 2);
+        return (low + high) / 2.0;
+    }
+
+    // Самое частое значение, при равенстве — наименьшее
+    int mode() const {
+        if (total == 0) {
+            throw std::runtime_error("Массив пустой");
+        }
+        int best = 0;
+        for (int b = 1; b < BUCKETS; ++b) {
+            if (counts[b] > counts[best]) {
+                best = b;
+            }
+        }
+        return best + MIN_VALUE;
+    }
+
+private:
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+};
+
+// Сводка по части массива; сводки соседних частей складываются через merge
+struct ArraySummary {
+    size_t count;
+    long long sum;
+    int minVal;
+    int maxVal;
+    ValueHistogram histogram;
+
+    ArraySummary() : count(0), sum(0), minVal(ValueHistogram::MIN_VALUE + ValueHistogram::BUCKETS), maxVal(ValueHistogram::MIN_VALUE - 1) {}
+
+    void add(const int8_t* values, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        int lo, hi;
+        minMaxValues(values, n, lo, hi);
+        minVal = std::min(minVal, lo);
+        maxVal = std::max(maxVal, hi);
+        sum += sumValues(values, n);
+        histogram.add(values, n);
+        count += n;
+    }
+
+    void merge(const ArraySummary& other) {
+        count += other.count;
+        sum += other.sum;
+        minVal = std::min(minVal, other.minVal);
+        maxVal = std::max(maxVal, other.maxVal);
+        histogram.merge(other.histogram);
+    }
+};
+
+// Параллельная свертка: массив режется на куски по 256 КБ (помещаются в
+// кэш L2, и все проходы по куску, кроме первого, идут из кэша), потоки
+// берут куски по очереди, у каждого своя сводка, в конце они сливаются.
+// threads == 0 — по числу ядер.
+static ArraySummary summarizeParallel(const int8_t* values, size_t n, unsigned threads = 0) {
+    const size_t chunkSize = 256 * 1024;
+    size_t chunks = (n + chunkSize - 1) / chunkSize;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunks));
+    if (threads <= 1) {
+        ArraySummary summary;
+        for (size_t c = 0; c < chunks; ++c) {
+            summary.add(values + c * chunkSize, std::min(chunkSize, n - c * chunkSize));
+        }
+        return summary;
+    }
+
+    std::vector<ArraySummary> partial(threads);
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            for (size_t c = next++; c < chunks; c = next++) {
+                partial[t].add(values + c * chunkSize, std::min(chunkSize, n - c * chunkSize));
+            }
+        });
+    }
+    for (size_t t = 0; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        partial[0].merge(partial[t]);
+    }
+    return partial[0];
+}
+
 class ExtendedArray : public DynamicArray {
 public:
-    ExtendedArray(size_t arraySize = 0) : DynamicArray(arraySize) {}
+    ExtendedArray(size_t arraySize = 0) : DynamicArray(arraySize), statsReady(false) {}
     
-    ExtendedArray(const DynamicArray& other) : DynamicArray(other) {}
+    ExtendedArray(const DynamicArray& other) : DynamicArray(other), statsReady(false) {}
+
+    ExtendedArray(DynamicArray&& other) noexcept : DynamicArray(std::move(other)), statsReady(false) {}
+
+    template <typename Left, typename Right, bool Subtract>
+    ExtendedArray(const ArraySum<Left, Right, Subtract>& expr) : DynamicArray(expr), statsReady(false) {}
+
+    // Копия не читает кэш статистики источника: его может в это время
+    // пересчитывать константный метод из другого потока
+    ExtendedArray(const ExtendedArray& other) : DynamicArray(other), statsReady(false) {}
+    ExtendedArray(ExtendedArray&& other) noexcept = default;
+
+    ExtendedArray& operator=(const ExtendedArray& other) {
+        DynamicArray::operator=(other);
+        statsReady = false;
+        return *this;
+    }
+    ExtendedArray& operator=(ExtendedArray&& other) noexcept = default;
+
+    using DynamicArray::operator=;
+
+    // Статистика обновляется за O(1), если она была актуальна; изменения
+    // через ссылку на DynamicArray меняют версию, и тогда статистика
+    // пересчитывается целиком при следующем запросе
+    void pushBack(int value) {
+        bool current = statsCurrent();
+        DynamicArray::pushBack(value);
+        if (!current) {
+            return;
+        }
+        if (getSize() == 1) {
+            minVal = maxVal = value;
+            minStale = maxStale = false;
+        } else {
+            if (value < minVal) {
+                minVal = value;
+            }
+            if (value > maxVal) {
+                maxVal = value;
+            }
+        }
+        counts.add(value);
+        total += value;
+        statsVersion = getVersion();
+    }
+
+    void setValue(size_t index, int value) {
+        bool current = statsCurrent();
+        int old = getValue(index);
+        DynamicArray::setValue(index, value);
+        if (!current) {
+            return;
+        }
+        counts.remove(old);
+        counts.add(value);
+        total += value - old;
+        // Пересчет min/max откладывается, пока не понадобится
+        if (value <= minVal) {
+            minVal = value;
+            minStale = false;
+        } else if (old == minVal && counts.count(old) == 0) {
+            minStale = true;
+        }
+        if (value >= maxVal) {
+            maxVal = value;
+            maxStale = false;
+        } else if (old == maxVal && counts.count(old) == 0) {
+            maxStale = true;
+        }
+        statsVersion = getVersion();
+    }
     
     double calculateAverage() const {
         size_t currentSize = getSize();
@@ -156,34 +728,37 @@ public:
             throw std::runtime_error("Массив пустой");
         }
         
-        int sum = 0;
-        for (size_t i = 0; i < currentSize; ++i) {
-            sum += getValue(i);
-        }
-        
-        return static_cast<double>(sum) / currentSize;
+        std::lock_guard<std::mutex> lock(statsMutex.mutex);
+        updateStats();
+        return static_cast<double>(total) / currentSize;
     }
     
     double calculateMedian() const {
-        size_t currentSize = getSize();
-        if (currentSize == 0) {
-            throw std::runtime_error("Массив пустой");
-        }
-        
-        std::vector<int> sortedData;
-        for (size_t i = 0; i < currentSize; ++i) {
-            sortedData.push_back(getValue(i));
-        }
-        
-        std::sort(sortedData.begin(), sortedData.end());
-        
-        if (currentSize % 2 == 0) {
-            int mid1 = sortedData[currentSize / 2 - 1];
-            int mid2 = sortedData[currentSize / 2];
-            return (mid1 + mid2) / 2.0;
-        } else {
-            return sortedData[currentSize / 2];
-        }
+        return histogram().median();
+    }
+
+    double calculateQuantile(double q) const {
+        return histogram().quantile(q);
+    }
+
+    int calculateMode() const {
+        return histogram().mode();
+    }
+
+    size_t countValue(int value) const {
+        return static_cast<size_t>(histogram().count(value));
+    }
+
+    // Гистограмма меняется только неконстантными методами, поэтому ссылку
+    // можно читать из нескольких потоков, пока массив не изменяют
+    const ValueHistogram& histogram() const {
+        std::lock_guard<std::mutex> lock(statsMutex.mutex);
+        updateStats();
+        return counts;
+    }
+
+    ArraySummary summarize(unsigned threads = 0) const {
+        return summarizeParallel(getData(), getSize(), threads);
     }
     
     int findMin() const {
@@ -192,11 +767,13 @@ public:
             throw std::runtime_error("Массив пустой");
         }
         
-        int minVal = getValue(0);
-        for (size_t i = 1; i < currentSize; ++i) {
-            if (getValue(i) < minVal) {
-                minVal = getValue(i);
+        std::lock_guard<std::mutex> lock(statsMutex.mutex);
+        updateStats();
+        if (minStale) {
+            while (counts.count(minVal) == 0) {
+                ++minVal;
             }
+            minStale = false;
         }
         return minVal;
     }
@@ -207,14 +784,57 @@ public:
             throw std::runtime_error("Массив пустой");
         }
         
-        int maxVal = getValue(0);
-        for (size_t i = 1; i < currentSize; ++i) {
-            if (getValue(i) > maxVal) {
-                maxVal = getValue(i);
+        std::lock_guard<std::mutex> lock(statsMutex.mutex);
+        updateStats();
+        if (maxStale) {
+            while (counts.count(maxVal) == 0) {
+                --maxVal;
             }
+            maxStale = false;
         }
         return maxVal;
     }
+
+private:
+    // Константные методы досчитывают кэш под этим мьютексом, так что их
+    // можно вызывать из нескольких потоков одновременно. При копировании
+    // и перемещении мьютекс не переносится, у копии он свой
+    struct StatsMutex {
+        std::mutex mutex;
+
+        StatsMutex() {}
+        StatsMutex(const StatsMutex&) noexcept {}
+        StatsMutex& operator=(const StatsMutex&) noexcept {
+            return *this;
+        }
+    };
+
+    mutable StatsMutex statsMutex;
+    mutable ValueHistogram counts;
+    mutable long long total;
+    mutable int minVal, maxVal;
+    mutable bool minStale, maxStale;
+    mutable bool statsReady;
+    mutable size_t statsVersion;
+
+    bool statsCurrent() const {
+        return statsReady && statsVersion == getVersion();
+    }
+
+    void updateStats() const {
+        if (statsCurrent()) {
+            return;
+        }
+        // Один параллельный проход дает сразу сумму, min/max и гистограмму
+        ArraySummary summary = summarize();
+        counts = summary.histogram;
+        total = summary.sum;
+        minVal = summary.minVal;
+        maxVal = summary.maxVal;
+        minStale = maxStale = false;
+        statsReady = true;
+        statsVersion = getVersion();
+    }
 };
 
 int main() {
@@ -230,9 +850,79 @@ int main() {
         
         std::cout << "Среднее: " << arr.calculateAverage() << std::endl;
         std::cout << "Медиана: " << arr.calculateMedian() << std::endl;
+        std::cout << "Квартили: " << arr.calculateQuantile(0.25) << ", " << arr.calculateQuantile(0.75) << std::endl;
+        std::cout << "Мода: " << arr.calculateMode() << std::endl;
         std::cout << "Минимум: " << arr.findMin() << std::endl;
         std::cout << "Максимум: " << arr.findMax() << std::endl;
 
+        ExtendedArray bulk;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1000000; ++i) {
+            bulk.pushBack(i % 201 - 100);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "1000000 pushBack: " << elapsed.count() << " мс, емкость: " << bulk.capacity() << std::endl;
+        bulk.shrink_to_fit();
+        std::cout << "После shrink_to_fit: " << bulk.capacity() << std::endl;
+
+        ExtendedArray a(1000), b(1000);
+        ExtendedArray result = a.add(b);
+        const int rounds = 100000;
+        size_t before = DynamicArray::getAllocations();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            result = (i % 2 == 0) ? a.subtract(b) : a.add(b);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Выделений памяти на result = a.add(b): "
+                  << static_cast<double>(DynamicArray::getAllocations() - before) / rounds
+                  << " (только сам результат), " << elapsed.count() / rounds * 1000 << " мкс" << std::endl;
+
+        before = DynamicArray::getAllocations();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            if (i % 2 == 0) {
+                result += b;
+            } else {
+                add_into(result, a, b);
+            }
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Выделений памяти на += и add_into: " << DynamicArray::getAllocations() - before << ", "
+                  << elapsed.count() / rounds * 1000 << " мкс" << std::endl;
+
+        ExtendedArray c(1000), d(1000);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            result = a.add(b).subtract(c).add(d);
+        }
+        std::chrono::duration<double, std::milli> eager = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            result = a + b - c + d;
+        }
+        std::chrono::duration<double, std::milli> fused = std::chrono::steady_clock::now() - start;
+        std::cout << "a.add(b).subtract(c).add(d): " << eager.count() / rounds * 1000 << " мкс, a + b - c + d: "
+                  << fused.count() / rounds * 1000 << " мкс" << std::endl;
+
+        ExtendedArray huge;
+        huge.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i) {
+            huge.pushBack(i % 201 - 100);
+        }
+        for (unsigned threads = 1; threads <= std::max(1u, std::thread::hardware_concurrency()); threads *= 2) {
+            start = std::chrono::steady_clock::now();
+            ArraySummary summary = huge.summarize(threads);
+            elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "Сводка по " << summary.count << " элементам, потоков " << threads << ": "
+                      << elapsed.count() << " мс, медиана " << summary.histogram.median() << std::endl;
+        }
+
+        before = DynamicArray::getAllocations();
+        ExtendedArray moved = std::move(result);
+        result = std::move(moved);
+        std::cout << "Выделений памяти при перемещении: " << DynamicArray::getAllocations() - before << std::endl;
+
     } catch (const std::exception& e) {
         std::cerr << "Ошибка: " << e.what() << std::endl;
     }
@@ -1,37 +1,201 @@
 #include <iostream>
 #include <stdexcept>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <string>
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define DYNAMIC_ARRAY_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define DYNAMIC_ARRAY_MMAP
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#elif !defined(DYNAMIC_ARRAY_MMAP)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+struct BinaryHeader {
+    char magic[4];
+    uint32_t elementSize;
+    uint64_t count;
+};
+
+static const char BINARY_MAGIC[4] = {'D', 'A', 'R', 'B'};
+
+static void unmapFile(void* mapping, size_t mappedBytes) {
+#if defined(_WIN32)
+    (void)mappedBytes;
+    UnmapViewOfFile(mapping);
+#elif defined(DYNAMIC_ARRAY_MMAP)
+    munmap(mapping, mappedBytes);
+#else
+    (void)mapping;
+    (void)mappedBytes;
+#endif
+}
+
+static std::FILE* openExclusive(const std::string& filename, bool binary) {
+#ifdef _WIN32
+    int fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | (binary ? _O_BINARY : _O_TEXT),
+                   _S_IREAD | _S_IWRITE);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::FILE* file = _fdopen(fd, binary ? "wb" : "w");
+    if (!file) {
+        _close(fd);
+    }
+#else
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::FILE* file = fdopen(fd, binary ? "wb" : "w");
+    if (!file) {
+        close(fd);
+    }
+#endif
+    return file;
+}
+
+static void addClamped(const int* a, const int* b, int* out, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i low = _mm256_set1_epi32(-100);
+    const __m256i high = _mm256_set1_epi32(100);
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i sum = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(va, vb), low), high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sum);
+    }
+#endif
+    for (; i < n; ++i) {
+        int sum = a[i] + b[i];
+        out[i] = sum < -100 ? -100 : (sum > 100 ? 100 : sum);
+    }
+}
+
+static void subtractClamped(const int* a, const int* b, int* out, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i low = _mm256_set1_epi32(-100);
+    const __m256i high = _mm256_set1_epi32(100);
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i diff = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(va, vb), low), high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), diff);
+    }
+#endif
+    for (; i < n; ++i) {
+        int diff = a[i] - b[i];
+        out[i] = diff < -100 ? -100 : (diff > 100 ? 100 : diff);
+    }
+}
 
 class DynamicArray {
 protected:
     int* data;
     size_t size;
+    size_t allocated;
+    void* mapping;
+    size_t mappedBytes;
+
+private:
+    void reallocate(size_t newCapacity) {
+        if (newCapacity > SIZE_MAX / sizeof(int)) {
+            throw std::bad_alloc();
+        }
+        if (mappedBytes > 0) {
+            int* newData = nullptr;
+            if (newCapacity > 0) {
+                newData = static_cast<int*>(std::malloc(newCapacity * sizeof(int)));
+                if (!newData) {
+                    throw std::bad_alloc();
+                }
+                std::memcpy(newData, data, std::min(size, newCapacity) * sizeof(int));
+            }
+            unmapFile(mapping, mappedBytes);
+            mapping = nullptr;
+            mappedBytes = 0;
+            data = newData;
+        } else if (newCapacity == 0) {
+            std::free(data);
+            data = nullptr;
+        } else {
+            int* newData = static_cast<int*>(std::realloc(data, newCapacity * sizeof(int)));
+            if (!newData) {
+                throw std::bad_alloc();
+            }
+            data = newData;
+        }
+        allocated = newCapacity;
+    }
 
 public:
-    DynamicArray(size_t arraySize = 0) : size(arraySize) {
+    DynamicArray(size_t arraySize = 0) : size(arraySize), allocated(arraySize), mapping(nullptr), mappedBytes(0) {
         if (size > 0) {
-            data = new int[size]();
+            data = static_cast<int*>(std::calloc(size, sizeof(int)));
+            if (!data) {
+                throw std::bad_alloc();
+            }
         } else {
             data = nullptr;
         }
     }
 
-    DynamicArray(const DynamicArray& other) : size(other.size) {
+    DynamicArray(const DynamicArray& other) : size(other.size), allocated(other.size), mapping(nullptr), mappedBytes(0) {
         if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = other.data[i];
+            data = static_cast<int*>(std::malloc(size * sizeof(int)));
+            if (!data) {
+                throw std::bad_alloc();
             }
+            std::memcpy(data, other.data, size * sizeof(int));
         } else {
             data = nullptr;
         }
     }
 
+    DynamicArray(DynamicArray&& other) noexcept
+        : data(other.data), size(other.size), allocated(other.allocated),
+          mapping(other.mapping), mappedBytes(other.mappedBytes) {
+        other.data = nullptr;
+        other.size = 0;
+        other.allocated = 0;
+        other.mapping = nullptr;
+        other.mappedBytes = 0;
+    }
+
     virtual ~DynamicArray() {
-        delete[] data;
+        if (mappedBytes > 0) {
+            unmapFile(mapping, mappedBytes);
+        } else {
+            std::free(data);
+        }
     }
 
     void print() const {
@@ -70,25 +234,85 @@ public:
         return size;
     }
 
+    size_t capacity() const {
+        return allocated;
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > allocated) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (allocated > size) {
+            reallocate(size);
+        }
+    }
+
     void pushBack(int value) {
         if (value < -100 || value > 100) {
             throw std::invalid_argument("Value must be between -100 and 100");
         }
 
-        int* newData = new int[size + 1];
-        
-        for (size_t i = 0; i < size; ++i) {
-            newData[i] = data[i];
+        if (size == allocated) {
+            reserve(allocated > 0 ? allocated * 2 : 4);
         }
-        
-        newData[size] = value;
-        
-        delete[] data;
-        data = newData;
+
+        data[size] = value;
         ++size;
     }
 
-    virtual void saveToFile() const = 0;
+    DynamicArray& operator=(const DynamicArray& other) = delete;
+
+    DynamicArray& operator+=(const DynamicArray& other) {
+        add_into(*this, *this, other);
+        return *this;
+    }
+
+    DynamicArray& operator-=(const DynamicArray& other) {
+        subtract_into(*this, *this, other);
+        return *this;
+    }
+
+    friend void add_into(DynamicArray& out, const DynamicArray& a, const DynamicArray& b) {
+        size_t common = (a.size < b.size) ? a.size : b.size;
+        size_t maxSize = (a.size > b.size) ? a.size : b.size;
+        out.reserve(maxSize);
+
+        addClamped(a.data, b.data, out.data, common);
+        const DynamicArray& longer = (a.size > b.size) ? a : b;
+        if (maxSize > common) {
+            std::memmove(out.data + common, longer.data + common, (maxSize - common) * sizeof(int));
+        }
+        out.size = maxSize;
+    }
+
+    friend void subtract_into(DynamicArray& out, const DynamicArray& a, const DynamicArray& b) {
+        size_t common = (a.size < b.size) ? a.size : b.size;
+        size_t maxSize = (a.size > b.size) ? a.size : b.size;
+        out.reserve(maxSize);
+
+        subtractClamped(a.data, b.data, out.data, common);
+        if (a.size > common) {
+            std::memmove(out.data + common, a.data + common, (a.size - common) * sizeof(int));
+        }
+        for (size_t i = common; i < b.size; ++i) {
+            out.data[i] = -b.data[i];
+        }
+        out.size = maxSize;
+    }
+
+    void swap(DynamicArray& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(allocated, other.allocated);
+        std::swap(mapping, other.mapping);
+        std::swap(mappedBytes, other.mappedBytes);
+    }
+
+    virtual std::string saveToFile() const = 0;
+    virtual void loadFromFile(const std::string& filename) = 0;
 
 protected:
     std::string getCurrentDateTime() const {
@@ -99,90 +323,178 @@ protected:
         ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d_%H-%M-%S");
         return ss.str();
     }
+
+    std::FILE* createNewFile(const std::string& extension, bool binary, std::string& filename) const {
+        std::string base = getCurrentDateTime();
+        filename = base + extension;
+        std::FILE* file = nullptr;
+        for (int attempt = 1; attempt < 1000; ++attempt) {
+            file = openExclusive(filename, binary);
+            if (file || errno != EEXIST) {
+                break;
+            }
+            filename = base + "_" + std::to_string(attempt) + extension;
+        }
+        if (!file) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        return file;
+    }
+
+    static void closeFile(std::FILE* file, bool written, const std::string& filename) {
+        if (std::fclose(file) != 0 || !written) {
+            throw std::runtime_error("Cannot write file: " + filename);
+        }
+    }
+
+    std::string writeNewFile(const std::string& extension, const char* bytes, size_t length) const {
+        std::string filename;
+        std::FILE* file = createNewFile(extension, false, filename);
+        closeFile(file, std::fwrite(bytes, 1, length, file) == length, filename);
+        return filename;
+    }
+
+    static std::string readWholeFile(const std::string& filename) {
+        std::FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+
+        std::string contents;
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            contents.append(chunk, n);
+        }
+        bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        if (failed) {
+            throw std::runtime_error("Cannot read file: " + filename);
+        }
+        return contents;
+    }
+
+    static char* writeNumber(char* out, long long value) {
+        return std::to_chars(out, out + 24, value).ptr;
+    }
+
+    static const char* readNumber(const char* first, const char* last, long long& value) {
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (result.ec != std::errc()) {
+            throw std::runtime_error("Malformed number in file");
+        }
+        return result.ptr;
+    }
+
+    static const char* expect(const char* first, const char* last, const char* text) {
+        size_t length = std::strlen(text);
+        if (static_cast<size_t>(last - first) < length || std::memcmp(first, text, length) != 0) {
+            throw std::runtime_error(std::string("Malformed file, expected: ") + text);
+        }
+        return first + length;
+    }
+
+    static const char* skipLineEnd(const char* first, const char* last) {
+        if (first != last && *first == '\r') {
+            ++first;
+        }
+        return expect(first, last, "\n");
+    }
+
+    void appendLoaded(long long value) {
+        if (value < -100 || value > 100) {
+            throw std::invalid_argument("Value must be between -100 and 100");
+        }
+        if (size == allocated) {
+            reserve(allocated > 0 ? allocated * 2 : 4);
+        }
+        data[size++] = static_cast<int>(value);
+    }
 };
 
 class ArrTxt : public DynamicArray {
 public:
     ArrTxt(size_t arraySize = 0) : DynamicArray(arraySize) {}
     ArrTxt(const DynamicArray& other) : DynamicArray(other) {}
+    ArrTxt(DynamicArray&& other) noexcept : DynamicArray(std::move(other)) {}
 
     ArrTxt add(const ArrTxt& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        ArrTxt result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int sum = val1 + val2;
-            
-            if (sum < -100) sum = -100;
-            if (sum > 100) sum = 100;
-            
-            result.data[i] = sum;
-        }
-
+        ArrTxt result;
+        add_into(result, *this, other);
         return result;
     }
 
     ArrTxt subtract(const ArrTxt& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        ArrTxt result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int diff = val1 - val2;
-            
-            if (diff < -100) diff = -100;
-            if (diff > 100) diff = 100;
-            
-            result.data[i] = diff;
-        }
-
+        ArrTxt result;
+        subtract_into(result, *this, other);
         return result;
     }
 
-    void saveToFile() const override {
-        std::string filename = getCurrentDateTime() + ".txt";
-        std::ofstream file(filename);
-        
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open file: " + filename);
-        }
-        
-        file << "Dynamic Array (TXT)\n";
-        file << "Size: " << size << "\n";
-        file << "Elements: ";
-        
+    std::string saveToFile() const override {
+        std::string buffer(64 + size * 6, '\0');
+        char* out = &buffer[0];
+        out = std::copy_n("Dynamic Array (TXT)\nSize: ", 26, out);
+        out = writeNumber(out, static_cast<long long>(size));
+        out = std::copy_n("\nElements: ", 11, out);
+
         if (size == 0) {
-            file << "empty";
+            out = std::copy_n("empty", 5, out);
         } else {
             for (size_t i = 0; i < size; ++i) {
-                file << data[i];
+                out = writeNumber(out, data[i]);
                 if (i < size - 1) {
-                    file << ", ";
+                    out = std::copy_n(", ", 2, out);
                 }
             }
         }
-        file << "\n";
-        
-        file.close();
+        *out++ = '\n';
+
+        std::string filename = writeNewFile(".txt", buffer.data(), out - buffer.data());
         std::cout << "Saved to: " << filename << std::endl;
+        return filename;
     }
 
-    ArrTxt& operator=(const ArrTxt& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
+    void loadFromFile(const std::string& filename) override {
+        std::string contents = readWholeFile(filename);
+        const char* first = contents.data();
+        const char* last = first + contents.size();
+
+        first = expect(first, last, "Dynamic Array (TXT)");
+        first = skipLineEnd(first, last);
+        first = expect(first, last, "Size: ");
+        long long count;
+        first = readNumber(first, last, count);
+        first = skipLineEnd(first, last);
+        first = expect(first, last, "Elements: ");
+
+        ArrTxt loaded;
+        if (count == 0) {
+            first = expect(first, last, "empty");
+        } else if (count > 0) {
+            loaded.reserve(std::min(static_cast<size_t>(count), static_cast<size_t>(last - first)));
+            for (long long i = 0; i < count; ++i) {
+                if (i > 0) {
+                    first = expect(first, last, ", ");
                 }
-            } else {
-                data = nullptr;
+                long long value;
+                first = readNumber(first, last, value);
+                loaded.appendLoaded(value);
             }
+        } else {
+            throw std::runtime_error("Malformed file, negative size");
+        }
+        first = skipLineEnd(first, last);
+        if (first != last) {
+            throw std::runtime_error("Malformed file, trailing data");
         }
+
+        swap(loaded);
+    }
+
+    ArrTxt(const ArrTxt& other) = default;
+    ArrTxt(ArrTxt&& other) noexcept = default;
+    ArrTxt& operator=(ArrTxt other) noexcept {
+        swap(other);
         return *this;
     }
 };
@@ -191,76 +503,246 @@ class ArrCSV : public DynamicArray {
 public:
     ArrCSV(size_t arraySize = 0) : DynamicArray(arraySize) {}
     ArrCSV(const DynamicArray& other) : DynamicArray(other) {}
+    ArrCSV(DynamicArray&& other) noexcept : DynamicArray(std::move(other)) {}
 
     ArrCSV add(const ArrCSV& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        ArrCSV result(maxSize);
-
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int sum = val1 + val2;
-            
-            if (sum < -100) sum = -100;
-            if (sum > 100) sum = 100;
-            
-            result.data[i] = sum;
-        }
-
+        ArrCSV result;
+        add_into(result, *this, other);
         return result;
     }
 
     ArrCSV subtract(const ArrCSV& other) const {
-        size_t maxSize = (size > other.size) ? size : other.size;
-        ArrCSV result(maxSize);
+        ArrCSV result;
+        subtract_into(result, *this, other);
+        return result;
+    }
+
+    std::string saveToFile() const override {
+        std::string buffer(16 + size * 27, '\0');
+        char* out = &buffer[0];
+        out = std::copy_n("Index,Value\n", 12, out);
 
-        for (size_t i = 0; i < maxSize; ++i) {
-            int val1 = (i < size) ? data[i] : 0;
-            int val2 = (i < other.size) ? other.data[i] : 0;
-            int diff = val1 - val2;
-            
-            if (diff < -100) diff = -100;
-            if (diff > 100) diff = 100;
-            
-            result.data[i] = diff;
+        for (size_t i = 0; i < size; ++i) {
+            out = writeNumber(out, static_cast<long long>(i));
+            *out++ = ',';
+            out = writeNumber(out, data[i]);
+            *out++ = '\n';
+        }
+
+        std::string filename = writeNewFile(".csv", buffer.data(), out - buffer.data());
+        std::cout << "Saved to: " << filename << std::endl;
+        return filename;
+    }
+
+    void loadFromFile(const std::string& filename) override {
+        std::string contents = readWholeFile(filename);
+        const char* first = contents.data();
+        const char* last = first + contents.size();
+
+        first = expect(first, last, "Index,Value");
+        first = skipLineEnd(first, last);
+
+        ArrCSV loaded;
+        loaded.reserve(static_cast<size_t>(std::count(first, last, '\n')));
+        while (first != last) {
+            long long index, value;
+            first = readNumber(first, last, index);
+            if (index != static_cast<long long>(loaded.size)) {
+                throw std::runtime_error("Malformed file, rows out of order");
+            }
+            first = expect(first, last, ",");
+            first = readNumber(first, last, value);
+            first = skipLineEnd(first, last);
+            loaded.appendLoaded(value);
         }
 
+        swap(loaded);
+    }
+
+    ArrCSV(const ArrCSV& other) = default;
+    ArrCSV(ArrCSV&& other) noexcept = default;
+    ArrCSV& operator=(ArrCSV other) noexcept {
+        swap(other);
+        return *this;
+    }
+};
+
+class ArrBin : public DynamicArray {
+public:
+    ArrBin(size_t arraySize = 0) : DynamicArray(arraySize) {}
+    ArrBin(const DynamicArray& other) : DynamicArray(other) {}
+    ArrBin(DynamicArray&& other) noexcept : DynamicArray(std::move(other)) {}
+
+    ArrBin add(const ArrBin& other) const {
+        ArrBin result;
+        add_into(result, *this, other);
         return result;
     }
 
-    void saveToFile() const override {
-        std::string filename = getCurrentDateTime() + ".csv";
-        std::ofstream file(filename);
-        
-        if (!file.is_open()) {
+    ArrBin subtract(const ArrBin& other) const {
+        ArrBin result;
+        subtract_into(result, *this, other);
+        return result;
+    }
+
+    bool isMapped() const {
+        return mappedBytes > 0;
+    }
+
+    std::string saveToFile() const override {
+        BinaryHeader header;
+        std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+        header.elementSize = sizeof(int);
+        header.count = size;
+
+        std::string filename;
+        std::FILE* file = createNewFile(".bin", true, filename);
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                       (size == 0 || std::fwrite(data, sizeof(int), size, file) == size);
+        closeFile(file, written, filename);
+        std::cout << "Saved to: " << filename << std::endl;
+        return filename;
+    }
+
+    void loadFromFile(const std::string& filename) override {
+        std::FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
             throw std::runtime_error("Cannot open file: " + filename);
         }
-        
-        file << "Index,Value\n";
-        
-        for (size_t i = 0; i < size; ++i) {
-            file << i << "," << data[i] << "\n";
+
+        long fileSize = -1;
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            fileSize = std::ftell(file);
+            std::rewind(file);
         }
-        
-        file.close();
-        std::cout << "Saved to: " << filename << std::endl;
+
+        ArrBin loaded;
+        BinaryHeader header;
+        bool ok = fileSize >= static_cast<long>(sizeof(header)) &&
+                  std::fread(&header, sizeof(header), 1, file) == 1 && validHeader(header) &&
+                  validCount(header, static_cast<size_t>(fileSize));
+        if (ok && header.count > 0) {
+            loaded.reserve(header.count);
+            ok = std::fread(loaded.data, sizeof(int), header.count, file) == header.count;
+            loaded.size = header.count;
+        }
+        std::fclose(file);
+        if (!ok) {
+            throw std::runtime_error("Malformed binary file: " + filename);
+        }
+        if (!inRange(loaded.data, loaded.size)) {
+            throw std::invalid_argument("Value must be between -100 and 100");
+        }
+
+        swap(loaded);
     }
 
-    ArrCSV& operator=(const ArrCSV& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
-                }
-            } else {
-                data = nullptr;
-            }
+    // Maps the file instead of copying it, so opening is O(1) in the file
+    // size. Read-only opens trust the values written by saveToFile and skip
+    // the range check; writable opens check them, since edits go back into
+    // the file. Where no mapping is available the file is copied with
+    // loadFromFile and false is returned.
+    bool openMapped(const std::string& filename, bool writable = false) {
+#ifdef DYNAMIC_ARRAY_MMAP
+        size_t bytes = 0;
+        void* mapping = mapFile(filename, writable, bytes);
+
+        const BinaryHeader* header = static_cast<const BinaryHeader*>(mapping);
+        if (!validHeader(*header) || !validCount(*header, bytes)) {
+            unmapFile(mapping, bytes);
+            throw std::runtime_error("Malformed binary file: " + filename);
         }
+        int* values = reinterpret_cast<int*>(static_cast<char*>(mapping) + sizeof(BinaryHeader));
+        if (writable && !inRange(values, header->count)) {
+            unmapFile(mapping, bytes);
+            throw std::invalid_argument("Value must be between -100 and 100");
+        }
+
+        ArrBin opened;
+        opened.data = values;
+        opened.size = header->count;
+        opened.allocated = header->count;
+        opened.mapping = mapping;
+        opened.mappedBytes = bytes;
+        swap(opened);
+        return true;
+#else
+        (void)writable;
+        loadFromFile(filename);
+        return false;
+#endif
+    }
+
+    ArrBin(const ArrBin& other) = default;
+    ArrBin(ArrBin&& other) noexcept = default;
+    ArrBin& operator=(ArrBin other) noexcept {
+        swap(other);
         return *this;
     }
+
+private:
+#if defined(_WIN32)
+    static void* mapFile(const std::string& filename, bool writable, size_t& bytes) {
+        HANDLE file = CreateFileA(filename.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+
+        void* mapping = nullptr;
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(BinaryHeader))) {
+            bytes = static_cast<size_t>(fileSize.QuadPart);
+            HANDLE section = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_WRITECOPY, 0, 0, nullptr);
+            if (section) {
+                mapping = MapViewOfFile(section, writable ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, 0);
+                CloseHandle(section);
+            }
+        }
+        CloseHandle(file);
+        if (!mapping) {
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        return mapping;
+    }
+#elif defined(DYNAMIC_ARRAY_MMAP)
+    static void* mapFile(const std::string& filename, bool writable, size_t& bytes) {
+        int fd = ::open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+
+        struct stat info;
+        void* mapping = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(BinaryHeader)) {
+            bytes = static_cast<size_t>(info.st_size);
+            mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        return mapping;
+    }
+#endif
+
+    static bool validHeader(const BinaryHeader& header) {
+        return std::memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) == 0 && header.elementSize == sizeof(int);
+    }
+
+    static bool validCount(const BinaryHeader& header, size_t fileSize) {
+        size_t body = fileSize - sizeof(BinaryHeader);
+        return body % sizeof(int) == 0 && header.count == body / sizeof(int);
+    }
+
+    static bool inRange(const int* values, size_t n) {
+        bool ok = true;
+        for (size_t i = 0; i < n; ++i) {
+            ok &= (values[i] >= -100) & (values[i] <= 100);
+        }
+        return ok;
+    }
 };
 
 int main() {
@@ -310,6 +792,76 @@ int main() {
         dynamicArray.print();
         dynamicArray.saveToFile();
 
+        std::cout << "\n=== Testing in-place operations ===" << std::endl;
+        ArrTxt sum;
+        add_into(sum, txtArray, dynamicArray);
+        sum.print();
+        sum -= dynamicArray;
+        sum.print();
+        sum += txtArray;
+        sum.print();
+
+        std::cout << "\n=== Testing save and load ===" << std::endl;
+        ArrCSV big;
+        big.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i) {
+            big.pushBack(i % 201 - 100);
+        }
+        ArrTxt bigTxt(big);
+
+        auto start = std::chrono::steady_clock::now();
+        std::string csvName = big.saveToFile();
+        std::string txtName = bigTxt.saveToFile();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Saved 2 x " << big.getSize() << " elements in " << elapsed.count() << " ms" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        ArrCSV csvLoaded;
+        csvLoaded.loadFromFile(csvName);
+        ArrTxt txtLoaded;
+        txtLoaded.loadFromFile(txtName);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Loaded 2 x " << csvLoaded.getSize() << " elements in " << elapsed.count() << " ms" << std::endl;
+
+        bool same = csvLoaded.getSize() == big.getSize() && txtLoaded.getSize() == big.getSize();
+        for (size_t i = 0; same && i < big.getSize(); ++i) {
+            same = csvLoaded.getValue(i) == big.getValue(i) && txtLoaded.getValue(i) == big.getValue(i);
+        }
+        std::cout << "Round trip " << (same ? "matches" : "differs") << std::endl;
+        std::remove(csvName.c_str());
+        std::remove(txtName.c_str());
+
+        std::cout << "\n=== Testing binary files ===" << std::endl;
+        ArrBin bigBin(big);
+        std::string binName = bigBin.saveToFile();
+
+        start = std::chrono::steady_clock::now();
+        ArrBin binLoaded;
+        binLoaded.loadFromFile(binName);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Loaded " << binLoaded.getSize() << " elements in " << elapsed.count() << " ms" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        ArrBin binMapped;
+        bool mapped = binMapped.openMapped(binName);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Mapped " << binMapped.getSize() << " elements in " << elapsed.count() << " ms"
+                  << (mapped ? "" : " (copied, no mmap)") << std::endl;
+        binMapped = ArrBin();
+
+        {
+            ArrBin writer;
+            writer.openMapped(binName, true);
+            writer.setValue(0, 42);
+        }
+        ArrBin reopened;
+        reopened.openMapped(binName);
+        std::cout << "First element after writing through the mapping: " << reopened.getValue(0) << std::endl;
+        reopened.pushBack(7);
+        std::cout << "After pushBack: mapped " << (reopened.isMapped() ? "yes" : "no")
+                  << ", size " << reopened.getSize() << std::endl;
+        std::remove(binName.c_str());
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
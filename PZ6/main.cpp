@@ -1,10 +1,33 @@
 #include <iostream>
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <cstdint>
+#include <utility>
 
 class DynamicArray {
 private:
     int* data;
     size_t size;
+    size_t allocated;
+
+    void reallocate(size_t newCapacity) {
+        if (newCapacity > SIZE_MAX / sizeof(int)) {
+            throw std::bad_alloc();
+        }
+        if (newCapacity == 0) {
+            std::free(data);
+            data = nullptr;
+        } else {
+            int* newData = static_cast<int*>(std::realloc(data, newCapacity * sizeof(int)));
+            if (!newData) {
+                throw std::bad_alloc();
+            }
+            data = newData;
+        }
+        allocated = newCapacity;
+    }
 
     bool validValue(int value) const {
         return (value >= -100 && value <= 100);
@@ -15,27 +38,37 @@ private:
     }
 
 public:
-    DynamicArray(size_t arraySize = 0) : size(arraySize) {
+    DynamicArray(size_t arraySize = 0) : size(arraySize), allocated(arraySize) {
         if (size > 0) {
-            data = new int[size]();
+            data = static_cast<int*>(std::calloc(size, sizeof(int)));
+            if (!data) {
+                throw std::bad_alloc();
+            }
         } else {
             data = nullptr;
         }
     }
 
-    DynamicArray(const DynamicArray& other) : size(other.size) {
+    DynamicArray(const DynamicArray& other) : size(other.size), allocated(other.size) {
         if (size > 0) {
-            data = new int[size];
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = other.data[i];
+            data = static_cast<int*>(std::malloc(size * sizeof(int)));
+            if (!data) {
+                throw std::bad_alloc();
             }
+            std::memcpy(data, other.data, size * sizeof(int));
         } else {
             data = nullptr;
         }
     }
 
+    DynamicArray(DynamicArray&& other) noexcept : data(other.data), size(other.size), allocated(other.allocated) {
+        other.data = nullptr;
+        other.size = 0;
+        other.allocated = 0;
+    }
+
     ~DynamicArray() {
-        delete[] data;
+        std::free(data);
     }
 
     void print() const {
@@ -79,22 +112,33 @@ public:
         return size;
     }
 
+    size_t capacity() const {
+        return allocated;
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > allocated) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (allocated > size) {
+            reallocate(size);
+        }
+    }
+
     void pushBack(int value) {
         if (!validValue(value)) {
             throw std::invalid_argument("Value " + std::to_string(value) + 
                                        " must be between -100 and 100");
         }
 
-        int* newData = new int[size + 1];
-        
-        for (size_t i = 0; i < size; ++i) {
-            newData[i] = data[i];
+        if (size == allocated) {
+            reserve(allocated > 0 ? allocated * 2 : 4);
         }
-        
-        newData[size] = value;
-        
-        delete[] data;
-        data = newData;
+
+        data[size] = value;
         ++size;
     }
 
@@ -134,22 +178,17 @@ public:
         return result;
     }
 
-    DynamicArray& operator=(const DynamicArray& other) {
-        if (this != &other) {
-            delete[] data;
-            size = other.size;
-            if (size > 0) {
-                data = new int[size];
-                for (size_t i = 0; i < size; ++i) {
-                    data[i] = other.data[i];
-                }
-            } else {
-                data = nullptr;
-            }
-        }
+    DynamicArray& operator=(DynamicArray other) noexcept {
+        swap(other);
         return *this;
     }
 
+    void swap(DynamicArray& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(allocated, other.allocated);
+    }
+
     int& operator[](size_t index) {
         if (!validIndex(index)) {
             throw std::out_of_range("Index " + std::to_string(index) + 